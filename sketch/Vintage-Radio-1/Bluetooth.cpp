@@ -2,36 +2,58 @@
 // Bluetooth.cpp
 #include "Bluetooth.h"
 #include "Config.h"
+#include "SerialBus.h"
+
+// Max time an AT command holds the listener waiting for its OK/ERR line.
+static const uint16_t BT_REPLY_WINDOW_MS = 100;
+
+// Attempts per AT command when the BT201 answers ERR.
+static const uint8_t BT_CMD_ATTEMPTS = 3;
 
 BluetoothModule::BluetoothModule(uint8_t rxPin, uint8_t txPin)
  : _rxPin(rxPin),
    _txPin(txPin),
    _baud(0),
    _active(false),
-   btSerial(rxPin, txPin) {
+   btSerial(rxPin, txPin),
+   _linesReady(0),
+   _partialLen(0),
+   _discardLine(false),
+   _statusLen(0),
+   _playState(BT_STATE_UNKNOWN) {
 }
 
 void BluetoothModule::begin(long baudRate) {
   _baud = baudRate;
-  btSerial.begin(_baud);
+  SerialBus::attach(SerialBus::LINK_BT, btSerial);
+  SerialBus::begin(SerialBus::LINK_BT, _baud);
   _active = true;
-  btSerial.listen();
 }
 
 void BluetoothModule::wake() {
   if (_active) return;
   if (_baud <= 0) return;
-  btSerial.begin(_baud);
+  SerialBus::begin(SerialBus::LINK_BT, _baud);
   _active = true;
-  btSerial.listen();
 }
 
 void BluetoothModule::sleep() {
   if (!_active) return;
   // Stop SoftwareSerial to avoid background ISR timing interference
-  btSerial.end();
+  SerialBus::end(SerialBus::LINK_BT);
   _active = false;
 
+  // Drop any half-forwarded passthrough traffic
+  _consoleRx.clear();
+  _btRx.clear();
+  _linesReady = 0;
+  _partialLen = 0;
+  _discardLine = false;
+
+  // State is unknown until the module reports again after wake().
+  _statusLen = 0;
+  _playState = BT_STATE_UNKNOWN;
+
   // Tri-state pins
   pinMode(_rxPin, INPUT);
   pinMode(_txPin, INPUT);
@@ -41,6 +63,10 @@ bool BluetoothModule::isActive() const {
   return _active;
 }
 
+BluetoothModule::PlayState BluetoothModule::playState() const {
+  return _playState;
+}
+
 void BluetoothModule::sendInitialCommands() {
   if (!_active) wake();
 
@@ -65,36 +91,162 @@ void BluetoothModule::sendInitialCommands() {
 
 void BluetoothModule::sendCommand(const __FlashStringHelper *cmd) {
   if (!_active) return;
-  btSerial.listen();
+
+  // Retry only on an explicit ERR; a missing reply (no module fitted) is not retried.
+  for (uint8_t attempt = 0; attempt < BT_CMD_ATTEMPTS; ++attempt) {
+    if (sendCommandOnce(cmd)) return;
+    DBG_BT2(F("[BT] ERR reply, retrying: "), cmd);
+  }
+}
+
+bool BluetoothModule::sendCommandOnce(const __FlashStringHelper *cmd) {
+  SerialBus::claim(SerialBus::LINK_BT, BT_REPLY_WINDOW_MS);
   btSerial.print(cmd);
   btSerial.print("\r\n");
-  delay(100);
+
+  // Keep listening on BT until the reply line ends or the window expires.
+  bool rejected = false;
+  bool lineStart = true;
+  while (SerialBus::inWindow(SerialBus::LINK_BT)) {
+    if (btSerial.available() <= 0) continue;
+    const char c = (char)btSerial.read();
+    if (lineStart && c == 'E') rejected = true; // "ERR"
+    lineStart = false;
+    if (c == '\n') SerialBus::release(SerialBus::LINK_BT);
+  }
+  return !rejected;
 }
 
 void BluetoothModule::passthrough() {
   if (!_active) return;
 
-  btSerial.listen();
+  // Never steal the listener from a link that is waiting for a reply.
+  if (!SerialBus::request(SerialBus::LINK_BT, 0)) return;
 
-  // PC -> BT201
-  if (Serial.available()) {
-    char buf[64];
-    size_t n = Serial.readBytesUntil('\n', buf, sizeof(buf) - 1);
-    buf[n] = '\0';
-    if (n > 0 && buf[n - 1] == '\r') buf[n - 1] = '\0';
+  // PC -> BT201 (complete lines only)
+  pumpConsoleToRing();
+  pumpRingToBt();
 
-    if (buf[0] != '\0') {
-      btSerial.print(buf);
-      btSerial.print("\r\n");
+  // BT201 -> PC
+  pumpBtToRing();
+  pumpRingToConsole();
+}
+
+// Pull at most one slice of console bytes into the line ring.
+// '\r' is dropped here; the BT201 line terminator is re-added on send.
+void BluetoothModule::pumpConsoleToRing() {
+  uint8_t budget = Config::BT_PASSTHROUGH_SLICE;
+  while (budget-- && Serial.available() > 0) {
+    // Ring full of complete lines: leave input in the USB RX buffer until
+    // the BT201 side drains (back-pressure instead of dropping lines).
+    if (_consoleRx.space() <= 1 && _linesReady > 0) return;
+
+    const uint8_t c = (uint8_t)Serial.read();
+    if (c == '\r') continue;
+
+    if (_discardLine) {
+      if (c == '\n') _discardLine = false;
+      continue;
+    }
 
-      // Optional passthrough debug (BT_DEBUG)
-      DBG_BT2(F("[BT] Sent: "), buf);
+    if (c == '\n') {
+      // Empty lines are not forwarded (matches previous behaviour).
+      if (_partialLen == 0) continue;
+      _consoleRx.push(c); // room for '\n' is always reserved below
+      _linesReady++;
+      _partialLen = 0;
+      continue;
     }
+
+    // Always keep room for the terminating '\n' of this line.
+    if (_consoleRx.space() <= 1) {
+      // Only reachable when this one line fills the whole ring (see above):
+      // drop it (only complete lines are ever sent), then skip to the next '\n'.
+      _consoleRx.dropNewest(_partialLen);
+      _partialLen = 0;
+      _discardLine = true;
+      DBG_BT(F("[BT] Passthrough line too long; dropped"));
+      continue;
+    }
+
+    _consoleRx.push(c);
+    _partialLen++;
   }
+}
 
-  // BT201 -> PC
-  while (btSerial.available()) {
-    char c = btSerial.read();
-    Serial.write(c);
+// Forward at most one slice of complete lines to the BT201.
+void BluetoothModule::pumpRingToBt() {
+  if (_linesReady == 0) return;
+
+  uint8_t budget = Config::BT_PASSTHROUGH_SLICE;
+  while (budget-- && !_consoleRx.isEmpty()) {
+    const uint8_t c = _consoleRx.pop();
+    if (c == '\n') {
+      btSerial.print("\r\n");
+      _linesReady--;
+      DBG_BT(F("[BT] Sent passthrough line"));
+      if (_linesReady == 0) return;
+      continue;
+    }
+    btSerial.write(c);
+  }
+}
+
+void BluetoothModule::pumpBtToRing() {
+  uint8_t budget = Config::BT_PASSTHROUGH_SLICE;
+  while (budget-- && btSerial.available() > 0 && !_btRx.isFull()) {
+    // Console is behind: leave the rest in the SoftwareSerial RX buffer.
+    const char c = (char)btSerial.read();
+    parseStatusByte(c);
+    _btRx.push((uint8_t)c);
+  }
+}
+
+// Write only what the USB Serial TX buffer can take without blocking.
+void BluetoothModule::pumpRingToConsole() {
+  int room = Serial.availableForWrite();
+  uint8_t budget = Config::BT_PASSTHROUGH_SLICE;
+  while (budget-- && room-- > 0 && !_btRx.isEmpty()) {
+    Serial.write(_btRx.pop());
+  }
+}
+
+void BluetoothModule::poll() {
+  if (!_active) return;
+  if (!SerialBus::request(SerialBus::LINK_BT, 0)) return;
+
+  uint8_t budget = Config::BT_PASSTHROUGH_SLICE;
+  while (budget-- && btSerial.available() > 0) {
+    parseStatusByte((char)btSerial.read());
+  }
+}
+
+// Status lines: "TS+00" disconnected, "TS+01" connected/paused, "TS+02" playing.
+// Anything else (OK/ERR replies, other pushes) is ignored.
+void BluetoothModule::parseStatusByte(char c) {
+  if (c == '\r') return;
+  if (c != '\n') {
+    if (_statusLen < sizeof(_statusLine)) _statusLine[_statusLen] = c;
+    if (_statusLen < 255) _statusLen++;
+    return;
+  }
+
+  const uint8_t len = _statusLen;
+  _statusLen = 0;
+  if (len != 5) return;
+  if (_statusLine[0] != 'T' || _statusLine[1] != 'S' || _statusLine[2] != '+') return;
+  if (_statusLine[3] != '0') return;
+
+  PlayState next = _playState;
+  switch (_statusLine[4]) {
+    case '0': next = BT_STATE_DISCONNECTED; break;
+    case '1': next = BT_STATE_PAUSED; break;
+    case '2': next = BT_STATE_PLAYING; break;
+    default: return;
+  }
+
+  if (next != _playState) {
+    _playState = next;
+    DBG_BT2(F("[BT] Play state: "), (uint8_t)_playState);
   }
 }
@@ -5,6 +5,7 @@
 
 #include <Arduino.h>
 #include <SoftwareSerial.h>
+#include "ByteRing.h"
 
 /*
   ============================================================
@@ -19,13 +20,36 @@
   - SoftwareSerial uses interrupt timing and can interfere with other timing-sensitive
     operations (including other SoftwareSerial instances and RC timing reads).
   - Sleeping avoids background listening overhead and reduces jitter.
+  - Which SoftwareSerial is listening is owned by SerialBus; this module never
+    calls listen() directly. AT commands hold a short receive window so the
+    BT201's OK/ERR reply is read before the listener can move.
 
   Optional passthrough:
-  - If enabled at compile time in the sketch, allows PC Serial Monitor <-> BT201 UART.
+  - If enabled at compile time (BT_PASSTHROUGH in Config.h), allows
+    PC Serial Monitor <-> BT201 UART.
+  - Non-blocking: both directions go through fixed ring buffers and each
+    passthrough() call services at most BT_PASSTHROUGH_SLICE bytes per direction.
+  - PC -> BT201 traffic is forwarded only as complete lines (terminated by '\n').
+  - BT201 -> PC traffic is written only as fast as the USB Serial TX buffer
+    accepts it, so a slow console never stalls loop().
+
+  Playback state:
+  - The BT201 pushes status lines ("TS+xx") when the phone connects,
+    disconnects, starts or pauses playback. poll() (or passthrough(), which
+    sees the same bytes) parses them into playState().
+  - Until the first status line arrives the state is BT_STATE_UNKNOWN, which
+    callers should treat like playing (full-rate visuals).
 */
 
 class BluetoothModule {
 public:
+  enum PlayState : uint8_t {
+    BT_STATE_UNKNOWN = 0,
+    BT_STATE_DISCONNECTED,   // no phone paired/connected
+    BT_STATE_PAUSED,         // connected, not streaming
+    BT_STATE_PLAYING         // connected, streaming audio
+  };
+
   BluetoothModule(uint8_t rxPin, uint8_t txPin);
 
   // Begin SoftwareSerial at baudRate and set as active listener.
@@ -34,9 +58,16 @@ public:
   // Send initial AT commands (stored in flash).
   void sendInitialCommands();
 
-  // Forward data between USB Serial and BT serial (only if UART is active).
+  // Service one slice of USB Serial <-> BT serial forwarding (only if UART is active).
+  // Never blocks; call every loop() iteration.
   void passthrough();
 
+  // Drain BT201 output and parse status lines (use instead of passthrough()).
+  // Never blocks; call every loop() iteration while the BT source is selected.
+  void poll();
+
+  PlayState playState() const;
+
   // Stop SoftwareSerial and tri-state pins (reduces interference).
   void sleep();
 
@@ -52,7 +83,27 @@ private:
   bool    _active;
   SoftwareSerial btSerial;
 
+  // Passthrough buffers (SRAM: 2 x 64 bytes + state)
+  ByteRing<64> _consoleRx;   // PC -> BT201, assembled into lines
+  ByteRing<64> _btRx;        // BT201 -> PC
+  uint8_t _linesReady;       // complete lines waiting in _consoleRx
+  uint8_t _partialLen;       // bytes of the line still being typed
+  bool    _discardLine;      // console line overflowed; drop until '\n'
+
+  // Status line parser ("TS+xx")
+  char      _statusLine[5];
+  uint8_t   _statusLen;
+  PlayState _playState;
+
   void sendCommand(const __FlashStringHelper *cmd);
+  bool sendCommandOnce(const __FlashStringHelper *cmd); // false on ERR reply
+
+  void pumpConsoleToRing();
+  void pumpRingToBt();
+  void pumpBtToRing();
+  void pumpRingToConsole();
+
+  void parseStatusByte(char c);
 };
 
 #endif // BLUETOOTH_H
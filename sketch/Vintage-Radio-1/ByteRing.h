@@ -0,0 +1,61 @@
+// ByteRing.h
+#pragma once
+#include <Arduino.h>
+
+/*
+ ============================================================
+ Fixed-size byte FIFO
+ ============================================================
+ Small ring buffer used to decouple serial producers/consumers so that
+ nothing in loop() has to block on a UART.
+
+ Notes:
+  - Capacity N must be a power of two (<= 128) so wrap is a single AND.
+  - One slot is never used, so usable capacity is N - 1 bytes.
+  - No heap, no virtuals; SRAM cost is exactly N + 2 bytes.
+*/
+
+template <uint8_t N>
+class ByteRing {
+  static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0,
+                "ByteRing capacity must be a power of two in 2..128.");
+
+public:
+  ByteRing() : _head(0), _tail(0) {}
+
+  void clear() { _head = _tail = 0; }
+
+  bool isEmpty() const { return _head == _tail; }
+  bool isFull() const { return (uint8_t)((_head + 1) & MASK) == _tail; }
+
+  uint8_t count() const { return (uint8_t)((_head - _tail) & MASK); }
+  uint8_t space() const { return (uint8_t)(MASK - count()); }
+
+  // Returns false (and drops the byte) if the ring is full.
+  bool push(uint8_t b) {
+    const uint8_t next = (uint8_t)((_head + 1) & MASK);
+    if (next == _tail) return false;
+    _buf[_head] = b;
+    _head = next;
+    return true;
+  }
+
+  // Remove the n most recently pushed bytes (n must be <= count()).
+  void dropNewest(uint8_t n) { _head = (uint8_t)((_head - n) & MASK); }
+
+  // Caller must check isEmpty() first.
+  uint8_t pop() {
+    const uint8_t b = _buf[_tail];
+    _tail = (uint8_t)((_tail + 1) & MASK);
+    return b;
+  }
+
+  uint8_t peek() const { return _buf[_tail]; }
+
+private:
+  static const uint8_t MASK = (uint8_t)(N - 1);
+
+  uint8_t _buf[N];
+  uint8_t _head;
+  uint8_t _tail;
+};
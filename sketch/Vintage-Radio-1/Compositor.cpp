@@ -0,0 +1,30 @@
+// Compositor.cpp
+#include "Compositor.h"
+
+namespace Compositor {
+
+  // One loop per mode: compose() with a constant mode inlines to the
+  // channel ops only.
+  void layer(CRGB *dst, const CRGB *src, uint8_t count, Mode mode, uint8_t alpha) {
+    switch (mode) {
+      case MODE_MAX:    for (uint8_t i = 0; i < count; ++i) compose(dst[i], src[i], MODE_MAX); break;
+      case MODE_ADD:    for (uint8_t i = 0; i < count; ++i) compose(dst[i], src[i], MODE_ADD); break;
+      case MODE_SCREEN: for (uint8_t i = 0; i < count; ++i) compose(dst[i], src[i], MODE_SCREEN); break;
+      case MODE_ALPHA:  for (uint8_t i = 0; i < count; ++i) compose(dst[i], src[i], MODE_ALPHA, alpha); break;
+    }
+  }
+
+  void layerSolid(CRGB *dst, uint8_t count, const CRGB &colour, Mode mode, uint8_t alpha) {
+    if (mode == MODE_ALPHA && alpha == 255) {
+      fill_solid(dst, count, colour);
+      return;
+    }
+    switch (mode) {
+      case MODE_MAX:    for (uint8_t i = 0; i < count; ++i) compose(dst[i], colour, MODE_MAX); break;
+      case MODE_ADD:    for (uint8_t i = 0; i < count; ++i) compose(dst[i], colour, MODE_ADD); break;
+      case MODE_SCREEN: for (uint8_t i = 0; i < count; ++i) compose(dst[i], colour, MODE_SCREEN); break;
+      case MODE_ALPHA:  for (uint8_t i = 0; i < count; ++i) compose(dst[i], colour, MODE_ALPHA, alpha); break;
+    }
+  }
+
+} // namespace Compositor
@@ -0,0 +1,74 @@
+// Compositor.h
+#pragma once
+#include <Arduino.h>
+#include <FastLED.h>
+
+/*
+ ============================================================
+ Column layer compositor
+ ============================================================
+ Themes build a frame as layers at column resolution (one CRGB per matrix
+ column, or per run), never per LED: a layer over the 32 columns is 1/8 of
+ the work of the same blend over the 256 pixels on the wire.
+
+ Modes (dst = dst <mode> src, per channel, saturating 8-bit):
+  - MODE_MAX     brighter of the two (fire: flame over glow bed)
+  - MODE_ADD     qadd8 sum (sparks, highlights)
+  - MODE_SCREEN  255 - (255-a)(255-b)/256 (soft add, never clips hard)
+  - MODE_ALPHA   lerp from dst to src by alpha (255 = src replaces dst)
+
+ compose() is inline for per-column use inside a renderer's own loop (the
+ mode is usually a constant, so the switch folds away); layer() and
+ layerSolid() apply a whole layer with the mode hoisted out of the loop.
+ EffectVM programs reach the same modes through OP_LAYER.
+*/
+
+namespace Compositor {
+
+  enum Mode : uint8_t {
+    MODE_MAX = 0,
+    MODE_ADD,
+    MODE_SCREEN,
+    MODE_ALPHA
+  };
+
+  static inline uint8_t screen8(uint8_t a, uint8_t b) {
+    return (uint8_t)(255 - scale8((uint8_t)(255 - a), (uint8_t)(255 - b)));
+  }
+
+  // dst = dst <mode> src. alpha is used by MODE_ALPHA only.
+  static inline void compose(CRGB &dst, const CRGB &src, Mode mode, uint8_t alpha = 255) {
+    switch (mode) {
+      case MODE_MAX:
+        if (src.r > dst.r) dst.r = src.r;
+        if (src.g > dst.g) dst.g = src.g;
+        if (src.b > dst.b) dst.b = src.b;
+        break;
+      case MODE_ADD:
+        dst.r = qadd8(dst.r, src.r);
+        dst.g = qadd8(dst.g, src.g);
+        dst.b = qadd8(dst.b, src.b);
+        break;
+      case MODE_SCREEN:
+        dst.r = screen8(dst.r, src.r);
+        dst.g = screen8(dst.g, src.g);
+        dst.b = screen8(dst.b, src.b);
+        break;
+      case MODE_ALPHA:
+        if (alpha == 255) {
+          dst = src;
+        } else {
+          dst.r = lerp8by8(dst.r, src.r, alpha);
+          dst.g = lerp8by8(dst.g, src.g, alpha);
+          dst.b = lerp8by8(dst.b, src.b, alpha);
+        }
+        break;
+    }
+  }
+
+  // Layer count per-column colours from src over dst.
+  void layer(CRGB *dst, const CRGB *src, uint8_t count, Mode mode, uint8_t alpha = 255);
+
+  // Layer one colour over count columns of dst.
+  void layerSolid(CRGB *dst, uint8_t count, const CRGB &colour, Mode mode, uint8_t alpha = 255);
+}
@@ -66,6 +66,9 @@ Notes:
 #ifndef BT_DEBUG
  #define BT_DEBUG 0
 #endif
+#ifndef BUS_DEBUG
+ #define BUS_DEBUG 0 // SoftwareSerial listener switches / lost bytes
+#endif
 #ifndef LED_STRIP_DEBUG
  #define LED_STRIP_DEBUG 0
 #endif
@@ -76,6 +79,27 @@ Notes:
  #define LED_DIAL_DEBUG 0
 #endif
 
+// ============================================================
+// Optional features
+// ============================================================
+// BT_PASSTHROUGH=1 forwards USB Serial <-> BT201 UART while the Bluetooth
+// source is selected (for AT-command configuration/troubleshooting).
+// Non-blocking; LEDs keep animating while it runs.
+#ifndef BT_PASSTHROUGH
+ #define BT_PASSTHROUGH 0
+#endif
+// NOISE_BENCH=1 (with DEBUG=1) times inoise8 vs Noise1D for the fire and
+// ember workloads, and the fire / ember renderers at both quality levels,
+// once at boot and prints the result.
+#ifndef NOISE_BENCH
+ #define NOISE_BENCH 0
+#endif
+// VM_BENCH=1 (with DEBUG=1) times the native renderers against their
+// EffectVM programs once at boot and prints the result.
+#ifndef VM_BENCH
+ #define VM_BENCH 0
+#endif
+
 // ============================================================
 // Debug macros per module (flash-string friendly)
 // ============================================================
@@ -159,6 +183,14 @@ Notes:
  #define DBG_BT2(a,b) do {} while (0)
 #endif
 
+#if (DEBUG == 1) && (BUS_DEBUG == 1)
+ #define DBG_BUS(x) debugln(x)
+ #define DBG_BUS2(a,b) do { debug(a); debugln(b); } while (0)
+#else
+ #define DBG_BUS(x) do {} while (0)
+ #define DBG_BUS2(a,b) do {} while (0)
+#endif
+
 #if (DEBUG == 1) && (LED_STRIP_DEBUG == 1)
  #define DBG_LED_STRIP(x) debugln(x)
  #define DBG_LED_STRIP2(a,b) do { debug(a); debugln(b); } while (0)
@@ -169,8 +201,10 @@ Notes:
 
 #if (DEBUG == 1) && (LED_MATRIX_DEBUG == 1)
  #define DBG_LED_MATRIX(x) debugln(x)
+ #define DBG_LED_MATRIX2(a,b) do { debug(a); debugln(b); } while (0)
 #else
  #define DBG_LED_MATRIX(x) do {} while (0)
+ #define DBG_LED_MATRIX2(a,b) do {} while (0)
 #endif
 
 #if (DEBUG == 1) && (LED_DIAL_DEBUG == 1)
@@ -201,6 +235,19 @@ namespace Config {
   // WS2812B 8x32 LED matrix data pin
   constexpr uint8_t PIN_MATRIX_DATA = 7; // D7
 
+  // How the matrix panel is wired (MatrixLayout.h). The data line runs
+  // down each 8-LED column (COLUMNS) or along each 32-LED row (ROWS), in
+  // the same direction every line or zig-zag (SERPENTINE). MIRRORED: the
+  // first LED on the wire is in the right-hand column.
+  enum MatrixWiring : uint8_t {
+    WIRING_COLUMNS = 0,
+    WIRING_COLUMNS_SERPENTINE,
+    WIRING_ROWS,
+    WIRING_ROWS_SERPENTINE
+  };
+  constexpr MatrixWiring MATRIX_WIRING = WIRING_COLUMNS;
+  constexpr bool MATRIX_MIRRORED = false;
+
   // Tuning input (RC timing input)
   constexpr uint8_t PIN_TUNING_INPUT = 8; // D8
 
@@ -209,6 +256,10 @@ namespace Config {
   constexpr uint8_t PIN_BT_TX = 9;  // D9  (Arduino TX for BT RX)
   constexpr long BT_BAUD = 57600;
 
+  // Max bytes moved per direction per BluetoothModule::passthrough() call.
+  // At 57600 baud a 16-byte slice costs ~2.8 ms of SoftwareSerial TX.
+  constexpr uint8_t BT_PASSTHROUGH_SLICE = 16;
+
   // MP3 module UART (SoftwareSerial)
   constexpr uint8_t PIN_MP3_RX = 12; // D12 (Arduino RX for MP3 TXD)
   constexpr uint8_t PIN_MP3_TX = 11; // D11 (Arduino TX for MP3 RXD)
@@ -222,6 +273,18 @@ namespace Config {
 
   // UPDATED: 128 LEDs in the strip
   constexpr uint16_t STRIP_NUM_LEDS = 90;
+
+  // 5V LED supply budget shared by matrix + strip (5 V x 1200 mA)
+  constexpr uint32_t LED_POWER_BUDGET_MW = 5UL * 1200UL;
+
+  // Share of loop time one LED surface may spend on render + push (%).
+  // A matrix push alone is ~7.7 ms; FrameScheduler slows a surface's frame
+  // rate (down to its theme's slowest rate) to stay within this.
+  constexpr uint8_t LED_CPU_BUDGET_PCT = 35;
+
+  // Theme change crossfade: the previous theme's last frame blends into the
+  // new theme over this time (ms; 0 = switch instantly).
+  constexpr uint16_t THEME_FADE_MS = 600;
 }
 
 // ============================================================
@@ -1,6 +1,7 @@
 
 // DisplayLED.cpp
 #include "DisplayLED.h"
+#include "PhaseClock.h"
 
 namespace DisplayLED {
   static uint8_t  s_pin = 255;
@@ -29,7 +30,7 @@ namespace DisplayLED {
     if (now - s_lastTickMs < tickMs) return;
     s_lastTickMs = now;
 
-    const uint8_t pulse = beatsin8(bpm, minBright, maxBright);
+    const uint8_t pulse = PhaseClock::beatsin8(bpm, minBright, maxBright);
     if (pulse != s_currentBright) {
       s_currentBright = pulse;
       analogWrite(s_pin, s_currentBright);
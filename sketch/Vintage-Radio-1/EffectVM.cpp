@@ -0,0 +1,205 @@
+// EffectVM.cpp
+#include "EffectVM.h"
+#include "Compositor.h"
+#include "NoiseField.h"
+#include "PhaseClock.h"
+
+namespace EffectVM {
+
+  static const TProgmemRGBPalette16 *const PALETTES[] PROGMEM = {
+    &PartyColors_p, &HeatColors_p, &RainbowColors_p, &OceanColors_p,
+    &LavaColors_p, &ForestColors_p, &CloudColors_p
+  };
+  static const uint8_t PALETTE_COUNT = (uint8_t)(sizeof(PALETTES) / sizeof(PALETTES[0]));
+
+  struct Machine {
+    uint8_t  stack[STACK_DEPTH];
+    uint8_t  sp;
+    CRGB     colour;
+    CRGB     kept;
+    uint16_t cursor;
+    uint16_t indexStep;   // INDEX per element, 8.8 (256 / count, set once per run)
+  };
+
+  static inline void push(Machine &m, uint8_t v) {
+    if (m.sp < STACK_DEPTH) m.stack[m.sp++] = v;
+  }
+
+  static inline uint8_t pop(Machine &m) {
+    return (m.sp > 0) ? m.stack[--m.sp] : 0;
+  }
+
+  // Block length: len/256 of the surface, 0 = the rest (clamped to the rest).
+  static uint16_t blockLength(const Machine &m, const Sink &sink, uint8_t len) {
+    const uint16_t rest = (uint16_t)(sink.count - m.cursor);
+    if (len == 0) return rest;
+    const uint16_t n = (uint16_t)(((uint32_t)sink.count * len) >> 8);
+    return (n > rest) ? rest : n;
+  }
+
+  // Execute from pc until END or NEXT; returns the pc after it. position is
+  // INDEX for the element the code runs for (0..255 across the surface).
+  static const uint8_t *exec(Machine &m, const uint8_t *pc, const Sink &sink, uint8_t position);
+
+  static const uint8_t *skipBlock(const uint8_t *pc) {
+    // Step over the body of a FILL to its NEXT (FILL blocks do not nest).
+    for (;;) {
+      const uint8_t op = pgm_read_byte(pc++);
+      switch (op) {
+        case OP_END:  return pc - 1;
+        case OP_NEXT: return pc;
+        case OP_FIELD: case OP_PUSH: case OP_BEAT: case OP_PAL: case OP_LAYER: case OP_SPAN: case OP_FILL:
+          pc += 1; break;
+        case OP_RGB:     pc += 3; break;
+        case OP_BEATSIN: pc += 4; break;
+        default: break;
+      }
+    }
+  }
+
+  // INDEX advances by indexStep per element (an add, no divide per element).
+  static void fill(Machine &m, const uint8_t *body, const Sink &sink, uint16_t length) {
+    const uint16_t first = m.cursor;
+    uint16_t pos8_8 = (uint16_t)((uint32_t)first * m.indexStep);
+    if (sink.put == nullptr) {
+      exec(m, body, sink, (uint8_t)(pos8_8 >> 8));
+      sink.run(first, length, m.colour);
+    } else {
+      for (uint16_t i = first; i < (uint16_t)(first + length); ++i) {
+        exec(m, body, sink, (uint8_t)(pos8_8 >> 8));
+        sink.put(i, m.colour);
+        pos8_8 = (uint16_t)(pos8_8 + m.indexStep);
+      }
+    }
+    m.cursor = (uint16_t)(first + length);
+  }
+
+  static const uint8_t *exec(Machine &m, const uint8_t *pc, const Sink &sink, uint8_t position) {
+    for (;;) {
+      const uint8_t op = pgm_read_byte(pc++);
+      switch (op) {
+        case OP_END:
+          return pc - 1;
+        case OP_NEXT:
+          return pc;
+
+        case OP_FIELD:
+          NoiseField::prepare((NoiseField::Theme)pgm_read_byte(pc++));
+          break;
+        case OP_PUSH:
+          push(m, pgm_read_byte(pc++));
+          break;
+        case OP_DUP: {
+          const uint8_t a = pop(m);
+          push(m, a);
+          push(m, a);
+          break;
+        }
+        case OP_INDEX:
+          push(m, position);
+          break;
+        case OP_BEAT:
+          push(m, PhaseClock::beat8(pgm_read_byte(pc++)));
+          break;
+        case OP_BEATSIN: {
+          const uint8_t bpm = pgm_read_byte(pc);
+          const uint8_t lo  = pgm_read_byte(pc + 1);
+          const uint8_t hi  = pgm_read_byte(pc + 2);
+          const uint8_t ph  = pgm_read_byte(pc + 3);
+          pc += 4;
+          push(m, PhaseClock::beatsin8(bpm, lo, hi, ph));
+          break;
+        }
+        case OP_SIN:
+          push(m, sin8(pop(m)));
+          break;
+        case OP_NOISE:
+          push(m, NoiseField::sampleA((uint16_t)pop(m) * NoiseField::ROW_LEN));
+          break;
+        case OP_NOISE2:
+          push(m, NoiseField::sampleB((uint16_t)pop(m) * NoiseField::ROW_LEN));
+          break;
+        case OP_ADD: {
+          const uint8_t b = pop(m);
+          push(m, qadd8(pop(m), b));
+          break;
+        }
+        case OP_SUB: {
+          const uint8_t b = pop(m);
+          push(m, qsub8(pop(m), b));
+          break;
+        }
+        case OP_SCALE: {
+          const uint8_t b = pop(m);
+          push(m, scale8(pop(m), b));
+          break;
+        }
+        case OP_RGB:
+          m.colour.r = pgm_read_byte(pc);
+          m.colour.g = pgm_read_byte(pc + 1);
+          m.colour.b = pgm_read_byte(pc + 2);
+          pc += 3;
+          break;
+        case OP_HSV: {
+          const uint8_t v = pop(m);
+          const uint8_t s = pop(m);
+          const uint8_t h = pop(m);
+          m.colour = CHSV(h, s, v);
+          break;
+        }
+        case OP_PAL: {
+          uint8_t id = pgm_read_byte(pc++);
+          if (id >= PALETTE_COUNT) id = PAL_PARTY;
+          const TProgmemRGBPalette16 *pal = (const TProgmemRGBPalette16 *)pgm_read_ptr(&PALETTES[id]);
+          m.colour = ColorFromPalette(*pal, pop(m), 255);
+          break;
+        }
+        case OP_DIM:
+          m.colour.nscale8_video(pop(m));
+          break;
+        case OP_KEEP:
+          m.kept = m.colour;
+          break;
+        case OP_BLEND:
+          m.colour = blend(m.kept, m.colour, pop(m));
+          break;
+        case OP_LAYER: {
+          const Compositor::Mode mode = (Compositor::Mode)pgm_read_byte(pc++);
+          const uint8_t alpha = (mode == Compositor::MODE_ALPHA) ? pop(m) : 255;
+          CRGB out = m.kept;
+          Compositor::compose(out, m.colour, mode, alpha);
+          m.colour = out;
+          break;
+        }
+        case OP_SPAN: {
+          const uint16_t length = blockLength(m, sink, pgm_read_byte(pc++));
+          if (length > 0) sink.run(m.cursor, length, m.colour);
+          m.cursor = (uint16_t)(m.cursor + length);
+          break;
+        }
+        case OP_FILL: {
+          const uint16_t length = blockLength(m, sink, pgm_read_byte(pc++));
+          if (length > 0) fill(m, pc, sink, length);
+          pc = skipBlock(pc);
+          break;
+        }
+        default:
+          DBG_LED_MATRIX2(F("[VM] Bad opcode: "), op);
+          return pc - 1;
+      }
+    }
+  }
+
+  void run(const uint8_t *program, const Sink &sink) {
+    if (program == nullptr || sink.count == 0) return;
+    Machine m;
+    m.sp = 0;
+    m.colour = CRGB::Black;
+    m.kept = CRGB::Black;
+    m.cursor = 0;
+    // 65536 / count: the one divide per frame (count 1 stays at INDEX 0).
+    m.indexStep = (sink.count > 1) ? (uint16_t)(65536UL / sink.count) : 0;
+    exec(m, program, sink, 0);
+  }
+
+} // namespace EffectVM
@@ -0,0 +1,102 @@
+// EffectVM.h
+#pragma once
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+
+/*
+ ============================================================
+ Effect bytecode interpreter (flash-cheap themes)
+ ============================================================
+ A theme can be a short PROGMEM program instead of C++ renderers: a few
+ bytes per surface instead of a renderer function in each LED module.
+ The program runs once per frame against a Sink (the matrix columns or
+ the strip span list).
+
+ Machine:
+  - 8-bit value stack (STACK_DEPTH), two colour registers (colour, kept)
+  - a cursor over the surface's elements; SPAN / FILL write from the
+    cursor and advance it. Block lengths are a fraction of the surface
+    (len/256 of the elements, 0 = the rest), so one program fits any
+    surface size.
+
+ Opcodes (immediates follow the opcode byte; "a b -> r" pops b then a):
+   END                     end of program
+   FIELD theme             NoiseField::prepare(theme) (call before NOISE)
+   PUSH v                  -> v
+   DUP                     a -> a a
+   INDEX                   -> element position across the surface (0..255)
+   BEAT bpm                -> PhaseClock::beat8(bpm)
+   BEATSIN bpm lo hi ph    -> PhaseClock::beatsin8(bpm, lo, hi, ph)
+   SIN                     x -> sin8(x)
+   NOISE / NOISE2          x -> noise row A / B at x (0..255 across the row)
+   ADD / SUB / SCALE       a b -> qadd8 / qsub8 / scale8(a, b)
+   RGB r g b               colour = (r, g, b)
+   HSV                     h s v -> colour = CHSV(h, s, v)
+   PAL id                  i -> colour = palette[id] at index i
+   DIM                     v -> colour.nscale8_video(v)
+   KEEP                    kept = colour
+   BLEND                   amt -> colour = blend(kept, colour, amt)
+   LAYER mode              [amt] -> colour = kept <mode> colour
+                           (Compositor::Mode; MODE_ALPHA pops amt)
+   SPAN len                fill len of the surface with colour (one run)
+   FILL len ... NEXT       run the body once per element, writing colour.
+                           Sinks without per-element storage (the strip)
+                           run the body once for the block and emit a run.
+
+ Programs are not validated at run time beyond stack and cursor bounds:
+ they are constants written next to the theme table.
+*/
+
+namespace EffectVM {
+
+  enum Op : uint8_t {
+    OP_END = 0,
+    OP_FIELD,
+    OP_PUSH,
+    OP_DUP,
+    OP_INDEX,
+    OP_BEAT,
+    OP_BEATSIN,
+    OP_SIN,
+    OP_NOISE,
+    OP_NOISE2,
+    OP_ADD,
+    OP_SUB,
+    OP_SCALE,
+    OP_RGB,
+    OP_HSV,
+    OP_PAL,
+    OP_DIM,
+    OP_KEEP,
+    OP_BLEND,
+    OP_LAYER,
+    OP_SPAN,
+    OP_FILL,
+    OP_NEXT
+  };
+
+  // PAL ids
+  enum PaletteId : uint8_t {
+    PAL_PARTY = 0,
+    PAL_HEAT,
+    PAL_RAINBOW,
+    PAL_OCEAN,
+    PAL_LAVA,
+    PAL_FOREST,
+    PAL_CLOUD
+  };
+
+  static const uint8_t STACK_DEPTH = 8;
+
+  // Where a program draws. put == nullptr: no per-element storage (FILL
+  // bodies run once per block and become a run).
+  struct Sink {
+    uint16_t count;                                              // elements
+    void (*put)(uint16_t index, const CRGB &colour);             // one element
+    void (*run)(uint16_t first, uint16_t length, const CRGB &colour); // uniform run
+  };
+
+  // Run program (PROGMEM) once against sink.
+  void run(const uint8_t *program, const Sink &sink);
+}
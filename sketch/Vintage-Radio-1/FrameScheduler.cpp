@@ -0,0 +1,123 @@
+// FrameScheduler.cpp
+#include "FrameScheduler.h"
+
+namespace FrameScheduler {
+
+  static const uint8_t COST_AVG_SHIFT = 3;   // running averages over ~8 frames
+  static const uint8_t STRAIN_FRAMES  = 8;   // loaded frames before QUALITY_LOW
+  static const uint8_t CALM_FRAMES    = 64;  // calm frames before QUALITY_FULL
+
+  struct SurfaceState {
+    Rate     rate;
+    uint16_t costUs;     // render + push average
+    uint16_t renderUs;   // render-only average
+    uint16_t lateQ4;     // start lateness average, ms x 16 (samples capped at intervalMs)
+    uint16_t intervalMs;
+    Quality  quality;
+    uint8_t  strain;     // loaded-frame counter (QUALITY_FULL)
+    uint8_t  calm;       // calm-frame counter (QUALITY_LOW)
+  };
+
+  static SurfaceState s_state[LedOutput::SURFACE_COUNT];
+
+  static inline uint16_t average(uint16_t avg, uint16_t sample) {
+    const int32_t diff = (int32_t)sample - (int32_t)avg;
+    return (uint16_t)((int32_t)avg + (diff >> COST_AVG_SHIFT));
+  }
+
+  // Recomputed only when the cost or rate changes (one divide per frame).
+  static void chooseInterval(SurfaceState &st) {
+    // cost (us) / (budget% * 10) = shortest interval (ms) within budget
+    uint16_t ms = (uint16_t)(st.costUs / (Config::LED_CPU_BUDGET_PCT * 10U));
+    if (ms < st.rate.targetMs) ms = st.rate.targetMs;
+    if (ms > st.rate.slowestMs) ms = st.rate.slowestMs;
+    st.intervalMs = ms;
+  }
+
+  // A frame is strained for either of two reasons, checked separately:
+  //  - over budget: the average render time exceeds Rate::renderBudgetUs
+  //  - late: frames start, on average, 3/8 of an interval or more after
+  //    they were due (loop loaded). Each sample counts at most one interval,
+  //    so a single stall (lights back on, a hold released) cannot trip it;
+  //    a loop that misses every other frame by an interval (average swings
+  //    around 1/2) or is a steady 2/3 interval late does. The other
+  //    surface's push alone (up to ~8 ms on a 30 ms interval) does not.
+  //    The average is kept in ms x 16: in whole ms the floored shift would
+  //    settle up to 7 ms below the true mean.
+  static void govern(SurfaceState &st) {
+    const uint16_t budget = st.rate.renderBudgetUs;
+    if (budget == 0) return;
+
+    const bool late = st.lateQ4 >= (uint16_t)(st.intervalMs * 6U);  // 3/8 interval, x 16
+    const bool overBudget = st.renderUs > budget;
+
+    if (st.quality == QUALITY_FULL) {
+      if (late || overBudget) {
+        if (++st.strain >= STRAIN_FRAMES) {
+          st.quality = QUALITY_LOW;
+          st.strain = 0;
+          st.calm = 0;
+          if (late) DBG_LED_MATRIX2(F("[LED] Quality low (late), late ms: "), st.lateQ4 >> 4);
+          else DBG_LED_MATRIX2(F("[LED] Quality low (budget), render us: "), st.renderUs);
+        }
+      } else if (st.strain > 0) {
+        st.strain--;
+      }
+    } else {
+      // Low quality renders cheaper, so require real headroom to go back.
+      if (!late && st.renderUs < (uint16_t)(budget - (budget >> 2))) {
+        if (++st.calm >= CALM_FRAMES) {
+          st.quality = QUALITY_FULL;
+          st.calm = 0;
+          DBG_LED_MATRIX2(F("[LED] Quality full, render us: "), st.renderUs);
+        }
+      } else {
+        st.calm = 0;
+      }
+    }
+  }
+
+  void declare(LedOutput::Surface surface, const Rate &rate) {
+    if (surface >= LedOutput::SURFACE_COUNT) return;
+    SurfaceState &st = s_state[surface];
+    st.rate = rate;
+    st.costUs = 0;
+    st.renderUs = 0;
+    st.lateQ4 = 0;
+    st.quality = QUALITY_FULL;
+    st.strain = 0;
+    st.calm = 0;
+    chooseInterval(st);
+  }
+
+  void recordFrame(LedOutput::Surface surface, uint16_t lateMs, uint16_t renderUs, uint16_t frameUs) {
+    if (surface >= LedOutput::SURFACE_COUNT) return;
+    SurfaceState &st = s_state[surface];
+    st.costUs = average(st.costUs, frameUs);
+    st.renderUs = average(st.renderUs, renderUs);
+    st.lateQ4 = average(st.lateQ4, (uint16_t)(((lateMs > st.intervalMs) ? st.intervalMs : lateMs) << 4));
+    govern(st);
+    chooseInterval(st);
+  }
+
+  uint16_t interval(LedOutput::Surface surface) {
+    return (surface < LedOutput::SURFACE_COUNT) ? s_state[surface].intervalMs : 0;
+  }
+
+  Quality quality(LedOutput::Surface surface) {
+    return (surface < LedOutput::SURFACE_COUNT) ? s_state[surface].quality : QUALITY_FULL;
+  }
+
+  uint16_t averageCostUs(LedOutput::Surface surface) {
+    return (surface < LedOutput::SURFACE_COUNT) ? s_state[surface].costUs : 0;
+  }
+
+  uint16_t averageRenderUs(LedOutput::Surface surface) {
+    return (surface < LedOutput::SURFACE_COUNT) ? s_state[surface].renderUs : 0;
+  }
+
+  uint16_t averageLateMs(LedOutput::Surface surface) {
+    return (surface < LedOutput::SURFACE_COUNT) ? (uint16_t)(s_state[surface].lateQ4 >> 4) : 0;
+  }
+
+} // namespace FrameScheduler
@@ -0,0 +1,81 @@
+// FrameScheduler.h
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+#include "LedOutput.h"
+
+/*
+ ============================================================
+ Adaptive frame rate + render quality (matrix + strip)
+ ============================================================
+ Each renderer declares how often it wants a frame (Rate): a target
+ interval and the slowest interval it still looks right at. A slow breath
+ does not need 33 fps; fire and the noise marbles do.
+
+ Per surface, the scheduler keeps a running average of what one frame
+ costs (render + dirty check + push, in us) and picks the frame interval:
+
+   interval = max(target, cost / Config::LED_CPU_BUDGET_PCT), <= slowest
+
+ so a surface whose frames get expensive drops towards its slowest rate
+ instead of eating the loop (and, while pushing, the interrupt-off time
+ SoftwareSerial suffers from). Slow themes declare long targets and so
+ spend a fraction of the CPU and push time of a 30 ms frame.
+
+ Quality governor:
+  - A Rate may also carry a render budget (us per frame, 0 = the renderer
+    has one quality level). Renderers with a budget support QUALITY_LOW
+    (e.g. fire / embers skip the fine noise octave).
+  - The surface drops to QUALITY_LOW after a few strained frames and
+    returns to QUALITY_FULL after a longer calm stretch. Strained means
+    either cause, tracked separately:
+      over budget: average render time > the Rate's render budget
+      late:        average start lateness >= 3/8 of the frame interval
+                   (loop loaded by MP3 traffic, tuning polls, debug
+                   output); a single stall does not count, a loop missing
+                   every other frame does
+    Lateness matters even when the render itself is within budget: the
+    loop has no time to spare, and shedding detail first keeps the frame
+    rate steady under load.
+
+ Usage from a surface:
+   FrameScheduler::declare(LedOutput::SURFACE_STRIP, rateForFolder);  // theme change
+   if (now - last < FrameScheduler::interval(LedOutput::SURFACE_STRIP)) return;
+   ...render at FrameScheduler::quality(...), then show, timed with micros()...
+   FrameScheduler::recordFrame(LedOutput::SURFACE_STRIP, lateMs, renderUs, frameUs);
+*/
+
+namespace FrameScheduler {
+
+  // Frame intervals in ms (target <= slowest); render budget in us.
+  struct Rate {
+    uint8_t  targetMs;
+    uint8_t  slowestMs;
+    uint16_t renderBudgetUs;
+  };
+
+  enum Quality : uint8_t {
+    QUALITY_LOW = 0,
+    QUALITY_FULL
+  };
+
+  // Set the surface's rate (theme change). Resets its cost averages and
+  // quality, so the new theme starts at its target in full quality.
+  void declare(LedOutput::Surface surface, const Rate &rate);
+
+  // Add one frame to the surface's averages: lateMs = how long after it was
+  // due the frame started, renderUs for the renderer alone, frameUs for
+  // render + push.
+  void recordFrame(LedOutput::Surface surface, uint16_t lateMs, uint16_t renderUs, uint16_t frameUs);
+
+  // Frame interval (ms) the surface should run at now.
+  uint16_t interval(LedOutput::Surface surface);
+
+  // Quality level the surface's renderer should use for its next frame.
+  Quality quality(LedOutput::Surface surface);
+
+  // Diagnostics: average frame / render cost (us), average lateness (ms).
+  uint16_t averageCostUs(LedOutput::Surface surface);
+  uint16_t averageRenderUs(LedOutput::Surface surface);
+  uint16_t averageLateMs(LedOutput::Surface surface);
+}
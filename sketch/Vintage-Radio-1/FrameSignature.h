@@ -0,0 +1,40 @@
+// FrameSignature.h
+#pragma once
+#include <Arduino.h>
+
+/*
+ ============================================================
+ Cheap per-frame content signature
+ ============================================================
+ Fletcher-style sums over a byte buffer, chainable across buffers. Used to
+ detect frames identical to the one already on the LEDs so the
+ (interrupts-off) WS2812 push can be skipped.
+
+ Both sums are mod 256 (plain uint8_t wrap): cheaper than Fletcher-16's
+ mod 255, and every byte value is distinct (mod 255 folds 0 and 255
+ together, so a black <-> full channel swap went unseen). A collision
+ still skips a frame that differs; paths that push once and stop (off
+ latch, start of a FRAME_HOLD) invalidate LedOutput first instead of
+ relying on the signature.
+
+ Cost on AVR: a few cycles per byte (~0.1 ms for matrix + strip).
+*/
+
+struct FrameSignature {
+  uint8_t a;
+  uint8_t b;
+
+  FrameSignature() : a(0), b(0) {}
+
+  inline void add(uint8_t v) {
+    a = (uint8_t)(a + v);
+    b = (uint8_t)(b + a);
+  }
+
+  inline void add(const void *data, uint16_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (len--) add(*p++);
+  }
+
+  inline uint16_t value() const { return (uint16_t)((uint16_t)b << 8 | a); }
+};
@@ -1,37 +1,65 @@
 
 // LedMatrix.cpp
 #include "LedMatrix.h"
+#include "Compositor.h"
+#include "FrameScheduler.h"
+#include "EffectVM.h"
+#include "LedOutput.h"
+#include "MatrixLayout.h"
+#include "NoiseField.h"
+#include "PhaseClock.h"
+#include "Playback.h"
+#include "Themes.h"
+#include "Ws2812.h"
 
 namespace LedMatrix {
 
-  CRGB leds[NUM_LEDS];
+  CRGB columns[MATRIX_WIDTH];
+
+  static Ws2812::Writer s_out(DATA_PIN);
+  typedef MatrixLayout::Panel<MATRIX_WIDTH, MATRIX_HEIGHT> Panel;
 
   static uint32_t lastFrameMs = 0;
+  static uint16_t s_frameDtMs = 0;   // elapsed time of the frame being rendered
   static bool s_isOffLatched = false;
-
-  // Folder 1
-  static uint32_t partyTime = 0;
+  static uint16_t s_frameIntervalMs = 0;   // setFrameInterval() floor (0 = none)
+  static bool s_frameOwed = false;         // render one frame despite FRAME_HOLD
+  static uint8_t s_shownBrightness = 0;    // global brightness of the last push
+  static uint8_t s_lastTheme = 0xFF;
 
   // Folder 4
   static uint8_t  s_externalSpookyBreath = 0xFF;
-  static uint16_t s_spookyPulseQ8_8 = 0;
+
+  // Per-theme state arena: only one theme renders at a time, so the themes
+  // share one block of SRAM (the largest theme's size, not the sum). Theme
+  // entry zeroes the part the theme uses (Themes::Theme::matrixStateBytes);
+  // the names below alias its fields. A baked theme (bakeBpm) keeps its
+  // keyframes here instead (it has no other state).
+  union ThemeState {
+    FireState   fire;         // folder 2
+    SpookyState spooky;       // folder 4
+  };
+  static ThemeState s_theme;
 
   // Folder 2
-  static uint8_t fireHeat[32] = {0};
-  static uint8_t glowTrack[32] = {0};
-  static uint8_t flickerTick = 0;
-  static uint8_t flickerJitter[32] = {0};
-  static uint32_t sparkNoiseTime = 0;
-  static uint32_t sparkNoiseTime2 = 0;
-  static int32_t sparkDriftX = 0;
+  static uint8_t  (&fireHeat)[MATRIX_WIDTH]      = s_theme.fire.heat;
+  static uint8_t  (&firePrevHeat)[MATRIX_WIDTH]  = s_theme.fire.prevHeat;
+  static uint8_t  (&glowTrack)[MATRIX_WIDTH]     = s_theme.fire.glow;
+  static uint8_t  (&flickerJitter)[MATRIX_WIDTH] = s_theme.fire.jitter;
+  static uint8_t  &flickerTick  = s_theme.fire.flickerTick;
+  static uint16_t &s_fireStepMs = s_theme.fire.stepMs;
+
+  // Folder 4
+  static uint16_t &s_spookyPulseQ8_8 = s_theme.spooky.pulseQ8_8;
 
-  static inline uint16_t blockBaseIndex(uint16_t column) { return column * 8; }
+  // Theme crossfade: the outgoing frame at half resolution (one colour per
+  // column pair), mixed under the new theme's frames by Themes::blend().
+  static const uint8_t FADE_SAMPLES = MATRIX_WIDTH / 2;
+  static CRGB s_fadeFrom[FADE_SAMPLES];
 
-  static inline uint8_t mixWeighted(uint8_t self, uint8_t neighbor, uint8_t neighborWeight) {
-    uint16_t acc = (uint16_t)self * (255 - neighborWeight) + (uint16_t)neighbor * neighborWeight;
-    return (uint8_t)(acc / 255);
-  }
-  static inline uint8_t mix8(uint8_t a, uint8_t b, uint8_t w) { return mixWeighted(a, b, w); }
+  // Baked program themes (keyframes in s_theme)
+  static Playback::Clip s_clip;
+  static bool s_clipValid = false;
 
   static inline uint16_t triwave16_local(uint16_t phase) {
     if (phase < 32768) return (uint16_t)((uint32_t)phase * 2U);
@@ -42,115 +70,195 @@ namespace LedMatrix {
     s_externalSpookyBreath = pulse;
   }
 
+  void setFrameInterval(uint16_t ms) {
+    // A hold keeps what the panel shows: start it with one frame that is
+    // sent whatever its signature says.
+    if (ms == FRAME_HOLD && s_frameIntervalMs != FRAME_HOLD) {
+      LedOutput::invalidate(LedOutput::SURFACE_MATRIX);
+      s_frameOwed = true;
+    }
+    s_frameIntervalMs = ms;
+  }
+
+  // A new theme starts from cold state (fire unlit, breath re-seeded,
+  // periodic programs baked).
+  static void enterTheme(const Themes::Theme &theme) {
+    uint16_t bytes = theme.matrixStateBytes;
+    if (bytes > sizeof(s_theme)) bytes = sizeof(s_theme);
+    memset(&s_theme, 0, bytes);
+    s_clipValid = theme.bakeBpm != 0 &&
+                  Playback::bake(s_clip, theme.matrixProgram, MATRIX_WIDTH, theme.bakeBpm,
+                                 &s_theme, sizeof(s_theme));
+    FrameScheduler::declare(LedOutput::SURFACE_MATRIX, theme.matrixRate);
+  }
+
+  // Snapshot what the panel shows (already a mix if a crossfade was running).
+  static void captureFade() {
+    for (uint8_t k = 0; k < FADE_SAMPLES; ++k) {
+      s_fadeFrom[k] = blend(columns[2 * k], columns[2 * k + 1], 128);
+    }
+  }
+
+  static void applyFade(uint8_t weight) {
+    for (uint8_t col = 0; col < MATRIX_WIDTH; ++col) {
+      CRGB c = s_fadeFrom[col >> 1];
+      Compositor::compose(c, columns[col], Compositor::MODE_ALPHA, weight);
+      columns[col] = c;
+    }
+  }
+
+  // Stream the column buffer to the panel in its wiring order (Panel, fixed
+  // at compile time by Config::MATRIX_WIRING). Only the matrix
+  // line is pushed, and only if the frame (or its brightness) changed: each
+  // push holds interrupts off for ~7.7 ms, which costs CPU and corrupts
+  // SoftwareSerial RX.
+  static void show() {
+    FrameSignature sig;
+    sig.add(columns, sizeof(columns));
+
+    uint8_t brightness;
+    const uint32_t unscaled_mW = calculate_unscaled_power_mW(columns, MATRIX_WIDTH) * MATRIX_HEIGHT;
+    if (!LedOutput::needsPush(LedOutput::SURFACE_MATRIX, sig, unscaled_mW, brightness)) return;
+
+    s_out.begin();
+    Panel::stream(s_out, columns, brightness);
+    s_out.end();
+  }
+
 } // namespace LedMatrix
 
 using namespace LedMatrix;
 
 void LedMatrix::begin() {
-  FastLED.addLeds<WS2812B, DATA_PIN, COLOR_ORDER>(leds, NUM_LEDS);
+  s_out.init();
   clear();
-  FastLED.show();
+  LedOutput::invalidate(LedOutput::SURFACE_MATRIX);
+  show();
   lastFrameMs = millis();
   s_isOffLatched = false;
 }
 
 void LedMatrix::clear() {
-  fill_solid(leds, NUM_LEDS, CRGB::Black);
+  fill_solid(columns, MATRIX_WIDTH, CRGB::Black);
+}
+
+// EffectVM sink: elements are columns.
+static void putColumn(uint16_t index, const CRGB &colour) {
+  columns[index] = colour;
+}
+
+static void runColumns(uint16_t first, uint16_t length, const CRGB &colour) {
+  fill_solid(&columns[first], length, colour);
 }
 
-static void renderPartyMarble() {
-  partyTime += LedMatrix::PARTY_TIME_NOISE_SPEED;
-  const uint8_t swirlA = beatsin8(7, 0, 255);
-  const uint8_t swirlB = beatsin8(13, 0, 255);
+static const EffectVM::Sink s_columnSink = { MATRIX_WIDTH, putColumn, runColumns };
+
+void LedMatrix::runProgram(const uint8_t *program) {
+  EffectVM::run(program, s_columnSink);
+}
+
+// Baked themes play their keyframes (same runs, no interpretation).
+void LedMatrix::renderProgram() {
+  if (s_clipValid) Playback::play(s_clip, s_columnSink);
+  else runProgram(Themes::current().matrixProgram);
+}
+
+void LedMatrix::renderParty() {
+  NoiseField::prepare(NoiseField::THEME_PARTY);
+  const uint8_t *noise = NoiseField::rowA();
 
   for (uint16_t col = 0; col < LedMatrix::MATRIX_WIDTH; ++col) {
-    uint32_t x = (uint32_t)col * LedMatrix::PARTY_COLUMN_NOISE_SCALE;
-    uint16_t z = (uint16_t)(partyTime + (swirlA / 2) + (swirlB / 3));
-    uint8_t n = inoise8((uint16_t)(x & 0xFFFF), z);
-    uint8_t index = qadd8(n, 30);
-    CRGB color = ColorFromPalette(PartyColors_p, index, 255);
-    uint16_t base = blockBaseIndex(col);
-    for (uint8_t i = 0; i < 8; ++i) leds[base + i] = color;
+    uint8_t index = qadd8(noise[col], 30);
+    columns[col] = ColorFromPalette(PartyColors_p, index, 255);
   }
 }
 
-static void renderFireColumns() {
-  for (uint8_t col = 0; col < 32; ++col) {
-    uint8_t cooldown = random8(0, ((FIRE_COOLING * 10) / 32) + FIRE_FLICKER_VARIANCE);
-    fireHeat[col] = (fireHeat[col] > cooldown) ? (fireHeat[col] - cooldown) : 0;
-  }
+// Finish one column of the fire kernel: store its diffused heat, track the
+// glow bed and roll its flicker jitter.
+static inline void finishFireColumn(uint8_t col, uint8_t heat, bool updateJitterNow) {
+  fireHeat[col] = heat;
+  glowTrack[col] = lerp8by8(glowTrack[col], heat, GLOW_TRACK_WEIGHT);
+  if (updateJitterNow) flickerJitter[col] = random8(FIRE_FLICKER_VARIANCE);
+}
 
-  sparkNoiseTime += FIRE_SPARK_NOISE_SPEED;
-  sparkNoiseTime2 += FIRE_SPARK_NOISE_SPEED2;
-  sparkDriftX += (int32_t)FIRE_SPARK_DRIFT_SPEED;
+// Column colours from the heat between the last two steps (frac, Q8) and
+// the glow bed: flame layer MAX over the glow. Runs once per frame.
+static void colourFireColumns(uint8_t frac) {
+  // Glow hue/sat are fixed: convert once, then scale by value per column.
+  static const CRGB glowFull = CHSV(GLOW_HUE, GLOW_SAT, 255);
 
-  for (uint8_t col = 0; col < 32; ++col) {
-    uint16_t x1 = (uint16_t)(col * FIRE_SPARK_NOISE_SCALE + (sparkDriftX & 0xFFFF));
-    uint16_t x2 = (uint16_t)(col * FIRE_SPARK_NOISE_SCALE2 - ((sparkDriftX / 2) & 0xFFFF));
-    uint8_t n1 = inoise8(x1, (uint16_t)sparkNoiseTime);
-    uint8_t n2 = inoise8(x2, (uint16_t)sparkNoiseTime2);
-    uint8_t nCombined = mix8(n1, n2, FIRE_SPARK_OCTAVE_BLEND);
+  for (uint8_t col = 0; col < MATRIX_WIDTH; ++col) {
+    // map(glow, 0, 255, GLOW_VAL_MIN, GLOW_VAL_MAX) as a scale8.
+    const uint8_t glowV = (uint8_t)(GLOW_VAL_MIN + scale8(glowTrack[col], GLOW_VAL_MAX - GLOW_VAL_MIN));
+    CRGB &px = columns[col];
+    px = glowFull;
+    px.nscale8_video(glowV);
 
-    uint8_t prob = (uint8_t)map(nCombined, 0, 255, FIRE_SPARK_MIN_PROB, FIRE_SPARK_MAX_PROB);
-    if (random8() < prob) {
-      fireHeat[col] = qadd8(
-        fireHeat[col],
-        random8(FIRE_GLOBAL_SPARK_HEAT_MIN, FIRE_GLOBAL_SPARK_HEAT_MAX)
-      );
-    }
-  }
+    const uint8_t heat = lerp8by8(firePrevHeat[col], fireHeat[col], frac);
+    const uint8_t vBase = qadd8(FIRE_BASE_BRIGHTNESS, flickerJitter[col]);
+    const CRGB flame = ColorFromPalette(HeatColors_p, heat, vBase);
 
-  for (uint8_t col = 31; col > 0; --col) {
-    fireHeat[col] = mixWeighted(fireHeat[col], fireHeat[col - 1], FIRE_DIFFUSE_WEIGHT);
-  }
-  for (uint8_t col = 0; col < 31; ++col) {
-    fireHeat[col] = mixWeighted(fireHeat[col], fireHeat[col + 1], FIRE_DIFFUSE_WEIGHT);
+    Compositor::compose(px, flame, Compositor::MODE_MAX);
   }
+}
 
-  for (uint8_t col = 0; col < 32; ++col) {
-    glowTrack[col] = lerp8by8(glowTrack[col], fireHeat[col], GLOW_TRACK_WEIGHT);
-  }
+// Fused single-pass fire kernel (no divides, no map()):
+//  - cooling, the spark roll and the flicker jitter each take their own
+//    random8() per column (the spark heat draws extra only when it fires)
+//  - the two diffusion passes (neighbour to the left, then to the right,
+//    each on the previous pass's values) run as a sliding window, so
+//    column col-1 is finished while column col is being heated
+//  - weights are lerp8by8 (multiply + shift) instead of "/ 255"
+// fine = false (QUALITY_LOW) drives the sparks from the broad octave only.
+static void stepFireColumns(bool fine) {
+  NoiseField::prepare(NoiseField::THEME_FIRE, fine);
+  const uint8_t *n1 = NoiseField::rowA();
+  const uint8_t *n2 = fine ? NoiseField::rowB() : n1;
+
+  static const uint8_t COOL_RANGE = (uint8_t)(((FIRE_COOLING * 10) / 32) + FIRE_FLICKER_VARIANCE);
+  static const uint8_t PROB_RANGE = (uint8_t)(FIRE_SPARK_MAX_PROB - FIRE_SPARK_MIN_PROB + 1);
 
   flickerTick++;
   const bool updateJitterNow = (flickerTick % FIRE_FLICKER_PERIOD) == 0;
-  if (updateJitterNow) {
-    for (uint8_t col = 0; col < 32; ++col) flickerJitter[col] = random8(0, FIRE_FLICKER_VARIANCE);
-  }
 
-  for (uint8_t col = 0; col < 32; ++col) {
-    uint8_t glowV = (uint8_t)map(glowTrack[col], 0, 255, GLOW_VAL_MIN, GLOW_VAL_MAX);
-    CHSV glowHSV(GLOW_HUE, GLOW_SAT, glowV);
-    CRGB baseGlow = glowHSV;
-
-    uint16_t base = blockBaseIndex(col);
-    for (uint8_t i = 0; i < 8; ++i) leds[base + i] = baseGlow;
-
-    uint8_t jitter = flickerJitter[col];
-    uint8_t vBase = qadd8(FIRE_BASE_BRIGHTNESS, jitter);
-    CRGB flame = ColorFromPalette(HeatColors_p, fireHeat[col], vBase);
-
-    for (uint8_t i = 0; i < 8; ++i) {
-      CRGB &px = leds[base + i];
-      px.r = max(px.r, flame.r);
-      px.g = max(px.g, flame.g);
-      px.b = max(px.b, flame.b);
+  uint8_t aPrev = 0; // previous column after cooling/sparks
+  uint8_t bPrev = 0; // previous column after the left-neighbour pass
+  for (uint8_t col = 0; col < MATRIX_WIDTH; ++col) {
+    // Cooling
+    uint8_t a = qsub8(fireHeat[col], random8(COOL_RANGE));
+
+    // Sparks: probability from the two noise octaves (map() as a shift)
+    const uint8_t nCombined = fine ? lerp8by8(n1[col], n2[col], FIRE_SPARK_OCTAVE_BLEND) : n1[col];
+    const uint8_t prob = (uint8_t)(FIRE_SPARK_MIN_PROB + (((uint16_t)nCombined * PROB_RANGE) >> 8));
+    if (random8() < prob) {
+      a = qadd8(a, random8(FIRE_GLOBAL_SPARK_HEAT_MIN, FIRE_GLOBAL_SPARK_HEAT_MAX));
+    }
+
+    // Pass 1 (left neighbour, pre-diffusion values)
+    const uint8_t b = (col > 0) ? lerp8by8(a, aPrev, FIRE_DIFFUSE_WEIGHT) : a;
+    aPrev = a;
+
+    // Pass 2 (right neighbour, pass-1 values) completes the previous column
+    if (col > 0) {
+      finishFireColumn((uint8_t)(col - 1), lerp8by8(bPrev, b, FIRE_DIFFUSE_WEIGHT),
+                       updateJitterNow);
     }
+    bPrev = b;
   }
+  finishFireColumn((uint8_t)(MATRIX_WIDTH - 1), bPrev, updateJitterNow);
 }
 
-static void renderXmasColumns() {
-  uint8_t brightA = beatsin8(XMAS_PULSE_BPM, XMAS_MIN_BRIGHT, XMAS_MAX_BRIGHT, 0, 0);
-  uint8_t brightB = beatsin8(XMAS_PULSE_BPM, XMAS_MIN_BRIGHT, XMAS_MAX_BRIGHT, 0, 128);
+void LedMatrix::renderXmas() {
+  uint8_t brightA = PhaseClock::beatsin8(XMAS_PULSE_BPM, XMAS_MIN_BRIGHT, XMAS_MAX_BRIGHT, 0);
+  uint8_t brightB = PhaseClock::beatsin8(XMAS_PULSE_BPM, XMAS_MIN_BRIGHT, XMAS_MAX_BRIGHT, 128);
 
-  for (uint16_t col = 0; col < 32; ++col) {
-    CRGB color = (col < 16) ? CRGB(brightA, 0, 0) : CRGB(0, brightB, 0);
-    uint16_t base = blockBaseIndex(col);
-    for (uint8_t i = 0; i < 8; ++i) leds[base + i] = color;
+  for (uint8_t col = 0; col < 32; ++col) {
+    columns[col] = (col < 16) ? CRGB(brightA, 0, 0) : CRGB(0, brightB, 0);
   }
 }
 
 // Folder 4 solid fog
-static void renderSpookySolid() {
+void LedMatrix::renderSpooky() {
   uint8_t pulse = 0;
   if (s_externalSpookyBreath != 0xFF) {
     pulse = s_externalSpookyBreath;
@@ -160,14 +268,16 @@ static void renderSpookySolid() {
     const uint8_t PULSE_MAX = 150;
 
     const uint16_t rangeQ8_8 = (uint16_t)(PULSE_MAX - PULSE_MIN) << 8;
-    const uint16_t phase16 = beat16(SPOOKY_PULSE_BPM);
+    const uint16_t phase16 = PhaseClock::beat16(SPOOKY_PULSE_BPM);
     const uint16_t tri16 = triwave16_local(phase16);
     const uint16_t targetQ8_8 =
       (uint16_t)(PULSE_MIN << 8) + (uint16_t)(((uint32_t)tri16 * (uint32_t)rangeQ8_8) >> 16);
 
+    // Smooth towards the target by 1/16 per nominal frame, scaled by dt.
     if (s_spookyPulseQ8_8 == 0) s_spookyPulseQ8_8 = targetQ8_8;
-    int16_t diff = (int16_t)(targetQ8_8 - s_spookyPulseQ8_8);
-    s_spookyPulseQ8_8 = (uint16_t)(s_spookyPulseQ8_8 + (diff >> 4));
+    const int32_t diff = (int32_t)targetQ8_8 - (int32_t)s_spookyPulseQ8_8;
+    const int32_t step = (diff * (int32_t)PhaseClock::framesQ8(s_frameDtMs)) >> 12;
+    s_spookyPulseQ8_8 = (uint16_t)((int32_t)s_spookyPulseQ8_8 + step);
     pulse = (uint8_t)(s_spookyPulseQ8_8 >> 8);
   }
 
@@ -187,45 +297,125 @@ static void renderSpookySolid() {
   const uint8_t edgeLevel = qadd8(40, scale8(pulseMatrix, 215));
   edge.nscale8_video(edgeLevel);
 
-  for (uint16_t col = 0; col < 32; ++col) {
-    CRGB color = fog;
-    if (col < EDGE_W || col >= (32 - EDGE_W)) color = edge;
+  // Layers: fog bed, edge bands over both ends.
+  fill_solid(columns, MATRIX_WIDTH, fog);
+  Compositor::layerSolid(columns, EDGE_W, edge, Compositor::MODE_ALPHA);
+  Compositor::layerSolid(&columns[MATRIX_WIDTH - EDGE_W], EDGE_W, edge, Compositor::MODE_ALPHA);
+}
 
-    uint16_t base = blockBaseIndex(col);
-    for (uint8_t i = 0; i < 8; ++i) leds[base + i] = color;
+// Folder 2: the heat simulation runs in fixed nominal-frame steps, as many
+// as the elapsed time covers, so its speed does not follow the frame rate.
+// The frame shows the heat interpolated between the last two steps by the
+// time left over, so a rate that does not divide the step (40 ms: 1, 1, 2
+// steps per frame) still moves evenly, one step behind the simulation.
+void LedMatrix::renderFire() {
+#if (DEBUG == 1) && (LED_MATRIX_DEBUG == 1)
+  // Fire kernel cost: average over 64 frames (us; x16 = cycles at 16 MHz).
+  static uint32_t fireUsSum = 0;
+  static uint8_t fireFrames = 0;
+  const uint32_t t0 = micros();
+#endif
+  const bool fine = FrameScheduler::quality(LedOutput::SURFACE_MATRIX) == FrameScheduler::QUALITY_FULL;
+  s_fireStepMs = (uint16_t)(s_fireStepMs + s_frameDtMs);
+  while (s_fireStepMs >= PhaseClock::NOMINAL_FRAME_MS) {
+    s_fireStepMs = (uint16_t)(s_fireStepMs - PhaseClock::NOMINAL_FRAME_MS);
+    memcpy(firePrevHeat, fireHeat, MATRIX_WIDTH);
+    for (uint8_t i = 0; i < FIRE_SPEED_SCALE; ++i) stepFireColumns(fine);
+  }
+  colourFireColumns((uint8_t)PhaseClock::framesQ8(s_fireStepMs));
+#if (DEBUG == 1) && (LED_MATRIX_DEBUG == 1)
+  fireUsSum += micros() - t0;
+  if (++fireFrames == 64) {
+    DBG_LED_MATRIX2(F("[MATRIX] Fire us/frame: "), fireUsSum / 64);
+    fireUsSum = 0;
+    fireFrames = 0;
   }
+#endif
 }
 
-void LedMatrix::update(uint8_t folder, bool lightsOn) {
-  const uint32_t now = millis();
+#if (DEBUG == 1) && (NOISE_BENCH == 1)
+// One nominal step per frame (FIRE_SPEED_SCALE kernel passes), with the
+// noise field recomputed every frame: the frame that pays for the field is
+// the one the governor's budget has to cover.
+void LedMatrix::benchmarkFire() {
+  static const uint8_t PASSES = 16;
+  uint32_t us[2];
+  for (uint8_t fine = 0; fine < 2; ++fine) {
+    const uint32_t t0 = micros();
+    for (uint8_t p = 0; p < PASSES; ++p) {
+      NoiseField::invalidate();
+      memcpy(firePrevHeat, fireHeat, MATRIX_WIDTH);
+      for (uint8_t i = 0; i < FIRE_SPEED_SCALE; ++i) stepFireColumns(fine != 0);
+      colourFireColumns(128);
+    }
+    us[fine] = (micros() - t0) / PASSES;
+  }
+  memset(&s_theme, 0, sizeof(s_theme));
+  clear();
+  debug(F("[NOISE] fire matrix us full/low: "));
+  debug(us[1]); debug(F(" / ")); debugln(us[0]);
+}
+#endif
 
-  if (!lightsOn || folder == 99) {
+void LedMatrix::update(bool lightsOn) {
+  const uint32_t now = PhaseClock::nowMs();
+  const Themes::Theme &theme = Themes::current();
+
+  // A dark theme (between stations) renders black until the crossfade into
+  // it has finished, then latches off.
+  const bool dark = theme.renderMatrix == nullptr;
+  if (!lightsOn || (dark && Themes::blend() == 255)) {
     if (!s_isOffLatched) {
+      // Pushed once and then never again: always send it.
       clear();
-      FastLED.show();
+      LedOutput::invalidate(LedOutput::SURFACE_MATRIX);
+      show();
       s_isOffLatched = true;
     }
     lastFrameMs = now;
     return;
   }
 
-  if (s_isOffLatched) s_isOffLatched = false;
-
-  if (now - lastFrameMs < FRAME_INTERVAL_MS) return;
-  lastFrameMs = now;
+  // Coming back on: the buffer is black, so one frame is rendered even
+  // under FRAME_HOLD.
+  if (s_isOffLatched) {
+    s_isOffLatched = false;
+    s_frameOwed = true;
+  }
 
-  switch (folder) {
-    case 1: renderPartyMarble(); break;
-    case 2:
-      for (uint8_t i = 0; i < FIRE_SPEED_SCALE; ++i) renderFireColumns();
-      break;
-    case 3: renderXmasColumns(); break;
-    case 4: renderSpookySolid(); break;
-    default:
-      clear();
-      FastLED.show();
-      return;
+  if (Themes::currentId() != s_lastTheme) {
+    s_lastTheme = Themes::currentId();
+    captureFade();
+    enterTheme(theme);
   }
 
-  FastLED.show();
+  uint16_t interval = FrameScheduler::interval(LedOutput::SURFACE_MATRIX);
+  if (interval < s_frameIntervalMs) interval = s_frameIntervalMs;
+  if (!s_frameOwed && (s_frameIntervalMs == FRAME_HOLD || now - lastFrameMs < interval)) {
+    // Between frames (or held): a brightness change re-pushes the held frame.
+    if (LedOutput::getBrightness() != s_shownBrightness) {
+      s_shownBrightness = LedOutput::getBrightness();
+      show();
+    }
+    return;
+  }
+  s_frameOwed = false;
+  s_frameDtMs = PhaseClock::elapsed(lastFrameMs);
+  const uint16_t lateMs = (s_frameDtMs > interval) ? (uint16_t)(s_frameDtMs - interval) : 0;
+  const uint32_t frameT0 = micros();
+
+  if (dark) clear();
+  else theme.renderMatrix();
+  const uint8_t weight = Themes::blend();
+  if (weight != 255) applyFade(weight);
+  const uint32_t renderUs = micros() - frameT0;
+
+  s_shownBrightness = LedOutput::getBrightness();
+  show();
+
+  // Render and push cost feed the frame rate and quality choice.
+  const uint32_t frameUs = micros() - frameT0;
+  FrameScheduler::recordFrame(LedOutput::SURFACE_MATRIX, lateMs,
+                              (renderUs > 0xFFFF) ? 0xFFFF : (uint16_t)renderUs,
+                              (frameUs > 0xFFFF) ? 0xFFFF : (uint16_t)frameUs);
 }
@@ -17,7 +17,11 @@
 
  Key constraint:
   - One solid color per column (8 LEDs per column are identical).
-    Each renderer computes one CRGB per column and applies it to the 8 LEDs.
+    Each renderer computes one CRGB per column into columns[] (32 x CRGB = 96 bytes).
+  - Output streams the panel with Ws2812::Writer in the panel's wiring order
+    (Config::MATRIX_WIRING, expanded at compile time by MatrixLayout.h), so
+    no 256-LED (768-byte) buffer exists in SRAM and renderers do not care
+    how the panel is wired.
 
  Operating modes:
   - Folder 1: Party / rainbow marble
@@ -26,12 +30,26 @@
   - Folder 4: Spooky (green/aqua marbling with breathing pulse)
 
  Brightness:
-  - Global FastLED brightness is controlled by the main sketch via FastLED.setBrightness().
+  - Global brightness is controlled by the main sketch via LedOutput::setBrightness().
     This module does not own brightness settings to avoid multiple sources of truth.
+  - LedOutput applies the shared matrix + strip power budget.
 
  Update model:
-  - LedMatrix::update(folder, lightsOn) is non-blocking and frame-throttled.
-  - If lightsOn is false OR folder==99, the matrix is cleared and latched OFF.
+  - LedMatrix::update(lightsOn) is non-blocking and frame-throttled. It renders
+    the theme selected in Themes (renderer, frame rate, state size come from
+    the theme table); FrameScheduler picks the actual interval from the
+    theme's rate and the measured frame cost. Fire also has a render budget:
+    over it (or with the loop loaded) it drops to QUALITY_LOW and skips the
+    fine spark octave.
+  - Pushes only the matrix line, and only when the frame changed (LedOutput).
+    The strip refreshes independently at its own rate.
+  - setFrameInterval() lets the main sketch slow or freeze rendering when the
+    audio source is idle (saves CPU, interrupt-off time and 5V current).
+  - A theme change crossfades from a snapshot of the previous frame
+    (Themes::blend()).
+  - If lightsOn is false OR the theme has no matrix renderer (between
+    stations, once the crossfade into it is done), the matrix is cleared
+    and latched OFF.
 
  Sync support:
   - setSpookyBreath(pulse) lets the main sketch provide a shared breath value so
@@ -44,28 +62,20 @@ namespace LedMatrix {
   static const uint8_t  DATA_PIN      = Config::PIN_MATRIX_DATA;
   static const uint16_t MATRIX_WIDTH  = 32; // columns
   static const uint16_t MATRIX_HEIGHT = 8;  // rows
-  static const uint16_t NUM_LEDS      = MATRIX_WIDTH * MATRIX_HEIGHT; // 256
-  static const EOrder   COLOR_ORDER   = GRB;
+  static const uint16_t NUM_LEDS      = MATRIX_WIDTH * MATRIX_HEIGHT; // 256 (on the wire)
 
-  // Frame pacing
-  static const uint16_t FRAME_INTERVAL_MS = 30;
+  // Frame pacing (per-theme rates live in the Themes table)
+  static const uint16_t FRAME_HOLD        = 0xFFFF; // setFrameInterval(): stop rendering
 
-  // Folder 1: Party marble (relaxed)
-  static const uint16_t PARTY_COLUMN_NOISE_SCALE = 4000;
-  static const uint16_t PARTY_TIME_NOISE_SPEED   = 3;
+  // Folder 1: Party marble - noise scale/speed live in NoiseField.h
 
-  // Folder 2: Fire columns
+  // Folder 2: Fire columns (LED_MATRIX_DEBUG prints the measured cost)
   static const uint8_t  FIRE_COOLING             = 55;
   static const uint8_t  FIRE_BASE_BRIGHTNESS     = 255;
   static const uint8_t  FIRE_FLICKER_VARIANCE    = 8;
   static const uint8_t  FIRE_FLICKER_PERIOD      = 16;
   static const uint8_t  FIRE_SPEED_SCALE         = 1;
-  static const uint16_t FIRE_SPARK_NOISE_SCALE   = 1800;
-  static const uint16_t FIRE_SPARK_NOISE_SPEED   = 9;
-  static const uint16_t FIRE_SPARK_NOISE_SCALE2  = 450;
-  static const uint16_t FIRE_SPARK_NOISE_SPEED2  = 17;
-  static const uint8_t  FIRE_SPARK_OCTAVE_BLEND  = 128;
-  static const uint16_t FIRE_SPARK_DRIFT_SPEED   = 3;
+  static const uint8_t  FIRE_SPARK_OCTAVE_BLEND  = 128; // spark noise: NoiseField.h
   static const uint8_t  FIRE_SPARK_MIN_PROB      = 1;
   static const uint8_t  FIRE_SPARK_MAX_PROB      = 10;
   static const uint8_t  FIRE_GLOBAL_SPARK_HEAT_MIN = 150;
@@ -87,17 +97,53 @@ namespace LedMatrix {
   static const uint16_t SPOOKY_TIME_NOISE_SPEED   = 1;
   static const uint16_t SPOOKY_COLUMN_NOISE_SCALE = 5000;
 
-  // LED buffer
-  extern CRGB leds[NUM_LEDS];
+  // Per-theme state: one arena holds the state of the running theme (sized
+  // for the largest); the theme table lists how much of it each theme uses.
+  struct FireState {
+    uint8_t  heat[MATRIX_WIDTH];
+    uint8_t  prevHeat[MATRIX_WIDTH];  // heat one step earlier (interpolation)
+    uint8_t  glow[MATRIX_WIDTH];
+    uint8_t  jitter[MATRIX_WIDTH];
+    uint16_t stepMs;        // elapsed time not yet simulated
+    uint8_t  flickerTick;
+  };
+  struct SpookyState {
+    uint16_t pulseQ8_8;     // smoothed fallback breath
+  };
+
+  // Column buffer (one colour per column; expanded to 8 LEDs on output)
+  extern CRGB columns[MATRIX_WIDTH];
 
   // API
   void begin();
   void clear();
-  void update(uint8_t folder, bool lightsOn);
+  void update(bool lightsOn);
+
+  // Theme renderers (registered in the Themes table): fill columns[].
+  // renderProgram() runs the theme's EffectVM program. renderParty() and
+  // renderXmas() are the native versions of programs in the table, kept as
+  // the VM_BENCH reference.
+  void renderProgram();
+  void runProgram(const uint8_t *program);
+  void renderParty();
+  void renderFire();
+  void renderXmas();
+  void renderSpooky();
 
   // Provide an external breath brightness (0..255) used by Folder 4 renderer.
   // Pass 0xFF to release and use internal fallback breathing.
   void setSpookyBreath(uint8_t pulse);
+
+  // Slow the frame rate down (e.g. low-rate idle while BT playback is paused):
+  // frames are at least ms apart. 0 = scheduled rate only, FRAME_HOLD = keep
+  // the last frame (no render; a brightness change re-pushes it, and turning
+  // the lights back on renders one frame).
+  void setFrameInterval(uint16_t ms);
+
+#if (DEBUG == 1) && (NOISE_BENCH == 1)
+  // Print the fire render time at both quality levels (render budget).
+  void benchmarkFire();
+#endif
 }
 
 #endif // LEDMATRIX_H
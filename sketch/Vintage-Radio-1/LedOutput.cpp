@@ -0,0 +1,65 @@
+// LedOutput.cpp
+#include "LedOutput.h"
+
+namespace LedOutput {
+
+  static uint8_t  s_brightness = 255;
+
+  static uint32_t s_power_mW[SURFACE_COUNT]   = { 0, 0 };
+  static uint16_t s_shownSig[SURFACE_COUNT]   = { 0, 0 };
+  static bool     s_haveShown[SURFACE_COUNT]  = { false, false };
+  static uint16_t s_pushed[SURFACE_COUNT]     = { 0, 0 };
+  static uint16_t s_skipped[SURFACE_COUNT]    = { 0, 0 };
+
+  // Scale the global brightness so all surfaces together stay in budget.
+  static uint8_t powerLimitedBrightness() {
+    uint32_t unscaled_mW = 0;
+    for (uint8_t s = 0; s < SURFACE_COUNT; ++s) unscaled_mW += s_power_mW[s];
+
+    const uint32_t requested_mW = (unscaled_mW * s_brightness) >> 8;
+    if (requested_mW <= Config::LED_POWER_BUDGET_MW) return s_brightness;
+    return (uint8_t)(((uint32_t)s_brightness * Config::LED_POWER_BUDGET_MW) / requested_mW);
+  }
+
+  void setBrightness(uint8_t brightness) {
+    s_brightness = brightness;
+  }
+
+  uint8_t getBrightness() {
+    return s_brightness;
+  }
+
+  void invalidate(Surface surface) {
+    if (surface >= SURFACE_COUNT) return;
+    s_haveShown[surface] = false;
+  }
+
+  bool needsPush(Surface surface, FrameSignature sig, uint32_t unscaled_mW, uint8_t &pushBrightness) {
+    if (surface >= SURFACE_COUNT) return false;
+
+    s_power_mW[surface] = unscaled_mW;
+    pushBrightness = powerLimitedBrightness();
+
+    // Brightness is part of the frame: a budget change caused by the other
+    // surface re-dirties this one at its next frame.
+    sig.add(pushBrightness);
+    if (s_haveShown[surface] && sig.value() == s_shownSig[surface]) {
+      s_skipped[surface]++;
+      return false;
+    }
+
+    s_shownSig[surface] = sig.value();
+    s_haveShown[surface] = true;
+    s_pushed[surface]++;
+    return true;
+  }
+
+  uint16_t pushedFrames(Surface surface) {
+    return (surface < SURFACE_COUNT) ? s_pushed[surface] : 0;
+  }
+
+  uint16_t skippedFrames(Surface surface) {
+    return (surface < SURFACE_COUNT) ? s_skipped[surface] : 0;
+  }
+
+} // namespace LedOutput
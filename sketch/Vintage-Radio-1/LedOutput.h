@@ -0,0 +1,51 @@
+// LedOutput.h
+#pragma once
+#include <Arduino.h>
+#include "Config.h"
+#include "FrameSignature.h"
+
+/*
+ ============================================================
+ LED Output Policy (matrix + strip)
+ ============================================================
+ Each LED surface (matrix, strip) renders at its own frame rate and pushes
+ only its own WS2812 line through its own Ws2812::Writer. This module holds
+ what the surfaces share:
+
+  - Global brightness (set by the main sketch; single source of truth)
+  - Combined power limit (Config::LED_POWER_BUDGET_MW across both surfaces)
+  - Per-surface dirty tracking: a surface is pushed only if its content
+    signature or its effective brightness changed since its last push
+
+ Usage from a surface, after rendering a frame:
+   FrameSignature sig; sig.add(buffer, size);
+   uint8_t bri;
+   if (LedOutput::needsPush(LedOutput::SURFACE_STRIP, sig, unscaled_mW, bri)) {
+     ...stream buffer at bri...
+   }
+*/
+
+namespace LedOutput {
+
+  enum Surface : uint8_t {
+    SURFACE_MATRIX = 0,
+    SURFACE_STRIP,
+    SURFACE_COUNT
+  };
+
+  // Global brightness (0..255), applied at output time.
+  void setBrightness(uint8_t brightness);
+  uint8_t getBrightness();
+
+  // Force the next needsPush() for surface to return true.
+  void invalidate(Surface surface);
+
+  // Record the surface's new frame and decide whether it must be transmitted.
+  // unscaled_mW: power of the frame at full brightness (all LEDs on the wire).
+  // On true, pushBrightness is the power-limited brightness to stream with.
+  bool needsPush(Surface surface, FrameSignature sig, uint32_t unscaled_mW, uint8_t &pushBrightness);
+
+  // Diagnostics: frames pushed / skipped as unchanged, per surface.
+  uint16_t pushedFrames(Surface surface);
+  uint16_t skippedFrames(Surface surface);
+}
@@ -2,188 +2,593 @@
 // LedStrip.cpp
 #include "LedStrip.h"
 #include "Config.h"
+#include "FrameScheduler.h"
+#include "EffectVM.h"
+#include "LedOutput.h"
+#include "NoiseField.h"
+#include "PhaseClock.h"
+#include "Playback.h"
+#include "Themes.h"
+#include "Ws2812.h"
 
 // NOTE:
-// This module intentionally does NOT call FastLED.show() inside update().
-// The main loop should call LedStrip::update() BEFORE LedMatrix::update().
-// LedMatrix::update() calls FastLED.show() which updates ALL controllers.
+// The strip pushes only its own line (Ws2812::Writer on PIN_STRIP_DATA) and
+// only when its frame changed. It is independent of LedMatrix::update().
 
 namespace LedStrip {
 
   // Hardware
   static const uint8_t DATA_PIN = Config::PIN_STRIP_DATA;
-  static const uint16_t NUM_LEDS = Config::STRIP_NUM_LEDS;
-  static const EOrder COLOR_ORDER = GRB;
 
-  // Frame pacing
-  static const uint16_t FRAME_INTERVAL_MS = 30;
-
-  // LED buffer (SRAM: NUM_LEDS * 3)
-  static CRGB s_leds[NUM_LEDS];
+  // LED buffer (MarbleState::px, SRAM: NUM_LEDS * 2): palette index + value
+  // per pixel. Expanded to RGB through s_palette only while streaming, so a
+  // palette swap needs no re-render.
+  static const TProgmemRGBPalette16 *s_palette = &PartyColors_p;
+  static bool s_paletteChanged = false;
+
+  static Ws2812::Writer s_out(DATA_PIN);
+
+  // Prefix-truncated push: WS2812 pixels keep their colour until new data
+  // reaches them, so only the LEDs up to the last changed one are sent.
+  // Changes are found per block of SIG_BLOCK LEDs against the signatures of
+  // the last pushed frame (SRAM: 2 bytes per block instead of a full copy,
+  // MarbleState::pushedBlockSig). A block whose signature collides would stay
+  // stale while nothing after it changes, so every FULL_PUSH_EVERY-th push
+  // sends the whole strip regardless (~1 s at 30 ms frames).
+  static const uint8_t FULL_PUSH_EVERY = 32;
+  static uint8_t  s_truncatedPushes = 0;
+  static uint8_t  s_pushedBrightness = 0;
+  static const TProgmemRGBPalette16 *s_pushedPalette = nullptr;
+  static bool     s_pushedValid = false; // false => next push sends the whole strip
+
+  // Span frames: themes made of a few uniform runs (spooky fog, xmas halves)
+  // describe the frame as (colour, length) runs instead of writing s_px.
+  // The output expands the runs while streaming. s_spanCount == 0 means the
+  // frame is in s_px.
+  struct Span {
+    CRGB colour;
+    uint8_t length;
+  };
+  static const uint8_t MAX_SPANS = 4;
+  static_assert(Config::STRIP_NUM_LEDS <= 255, "Span lengths are 8-bit.");
+  static uint8_t s_spanCount = 0;
+
+  // Per-theme state arena: the pixel frame (and its pushed block
+  // signatures) is only used by the marble themes and the span list only by
+  // the span themes, so they share storage. Theme entry (enterTheme())
+  // zeroes the theme's part (Themes::Theme::stripStateBytes) and forces a
+  // whole-strip push. The dark (between stations) theme uses the pixel
+  // frame (black). A baked span theme (bakeBpm) keeps its keyframes in the
+  // arena after the span list.
+  union ThemeState {
+    MarbleState marble;       // folders 1, 2
+    struct {
+      Span spans[MAX_SPANS];
+    } runs;                   // folders 3, 4 (rebuilt every frame)
+
+    ThemeState() {}           // CRGB has a constructor; storage is set up by enterTheme()
+  };
+  static ThemeState s_theme;
+
+  static Pixel    (&s_px)[NUM_LEDS]               = s_theme.marble.px;
+  static uint16_t (&s_pushedBlockSig)[SIG_BLOCKS] = s_theme.marble.pushedBlockSig;
+  static Span     (&s_spans)[MAX_SPANS]           = s_theme.runs.spans;
+
+  // Theme crossfade (see captureFade())
+  static CRGB    s_fadeFrom[SIG_BLOCKS];
+  static uint8_t s_shownBlend = 255;   // crossfade weight of the last push
+
+  // Baked program themes (keyframes in s_theme, after runs)
+  static Playback::Clip s_clip;
+  static bool s_clipValid = false;
 
   // State
   static uint32_t s_lastFrameMs = 0;
+  static uint16_t s_frameDtMs = 0;   // elapsed time of the frame being rendered
   static bool s_isOffLatched = false;
-  static uint8_t s_lastFolder = 255;
-
-  // Folder 1 (Party)
-  static uint32_t s_partyTime = 0;
-
-  // Folder 2 (Embers)
-  static uint32_t s_emberTime = 0;
-  static int32_t s_emberDriftX = 0;
+  static bool s_frameOwed = false;        // render one frame despite FRAME_HOLD
+  static uint8_t s_shownBrightness = 0;   // global brightness of the last push
+  static uint8_t s_lastTheme = 0xFF;
+  static uint16_t s_frameIntervalMs = 0;   // setFrameInterval() floor (0 = none)
 
   // Folder 4 (Spooky) - external breath override (0xFF = not set)
   static uint8_t s_externalSpookyBreath = 0xFF;
 
   // ------------------------------------------------------------
-  // Band widening control
+  // Anchor interpolation (folders 1, 2)
   // ------------------------------------------------------------
-  // Widen folder 1,2,4 by factor of 4 => one computed colour spans 4 LEDs.
-  static const uint8_t BLOCK_SIZE = 4;
-
-  // Feathering: light in-place blur after block rendering to reduce hard steps.
-  static const uint8_t FEATHER_PARTY  = 18;
-  static const uint8_t FEATHER_EMBER  = 34;
-  static const uint8_t FEATHER_SPOOKY = 18;
+  // One index/value pair is computed every ANCHOR_SPACING LEDs; the LEDs in
+  // between are a fixed-point linear ramp between neighbouring anchors,
+  // written in the same pass. Spacing must be a power of two (ramp step is a shift).
+  static const uint8_t ANCHOR_SHIFT = 2;
+  static const uint8_t ANCHOR_SPACING = (uint8_t)(1 << ANCHOR_SHIFT);
+  static const uint16_t ANCHOR_COUNT = (uint16_t)((NUM_LEDS - 1 + (ANCHOR_SPACING - 1)) / ANCHOR_SPACING + 1);
 
   void clear() {
-    fill_solid(s_leds, NUM_LEDS, CRGB::Black);
+    memset(s_px, 0, sizeof(s_px));
+    s_spanCount = 0;
+  }
+
+  void setPalette(const TProgmemRGBPalette16 &palette) {
+    if (s_palette == &palette) return;
+    s_palette = &palette;
+    s_paletteChanged = true;
   }
 
   void setSpookyBreath(uint8_t pulse) {
     s_externalSpookyBreath = pulse;
   }
 
-  // Write a single colour across a block [i .. i+BLOCK_SIZE-1], clamped to NUM_LEDS.
-  static inline void fillBlock(uint16_t i, const CRGB &c) {
-    for (uint8_t k = 0; k < BLOCK_SIZE; ++k) {
-      const uint16_t idx = (uint16_t)(i + k);
-      if (idx >= NUM_LEDS) break;
-      s_leds[idx] = c;
+  void setFrameInterval(uint16_t ms) {
+    // A hold keeps what the strip shows: start it with one whole-strip
+    // frame that is sent whatever its signatures say.
+    if (ms == FRAME_HOLD && s_frameIntervalMs != FRAME_HOLD) {
+      LedOutput::invalidate(LedOutput::SURFACE_STRIP);
+      s_pushedValid = false;
+      s_frameOwed = true;
+    }
+    s_frameIntervalMs = ms;
+  }
+
+  // Reset the arena for theme and pick its palette and frame rate. The
+  // pushed block signatures are invalid from here, so the next push is whole.
+  static void enterTheme(const Themes::Theme &theme) {
+    uint16_t bytes = theme.stripStateBytes;
+    if (bytes > sizeof(s_theme.marble)) bytes = sizeof(s_theme.marble);
+    memset(&s_theme.marble, 0, bytes);
+    s_spanCount = 0;
+    s_pushedValid = false;
+    if (theme.stripPalette != nullptr) setPalette(*theme.stripPalette);
+    s_clipValid = theme.bakeBpm != 0 &&
+                  Playback::bake(s_clip, theme.stripProgram, NUM_LEDS, theme.bakeBpm,
+                                 (uint8_t *)&s_theme + sizeof(s_theme.runs),
+                                 (uint16_t)(sizeof(s_theme) - sizeof(s_theme.runs)));
+    FrameScheduler::declare(LedOutput::SURFACE_STRIP, theme.stripRate);
+  }
+
+  // Ramp [start .. start+ANCHOR_SPACING-1] from a towards b (b sits on the
+  // next anchor), clamped to NUM_LEDS. 8.8 fixed point; the accumulators
+  // wrap as uint16_t. The index takes the short way round the palette
+  // (int8_t delta), the value always stays within 0..255.
+  static inline void rampSegment(uint16_t start, const Pixel &a, const Pixel &b) {
+    uint16_t idx = (uint16_t)a.index << 8;
+    uint16_t val = (uint16_t)a.value << 8;
+    // Per-LED step = delta / ANCHOR_SPACING in 8.8. The deltas are signed,
+    // so this multiplies (|delta| * 64 fits int16_t) instead of shifting.
+    const int16_t STEP_SCALE = 1 << (8 - ANCHOR_SHIFT);
+    const uint16_t dIdx = (uint16_t)((int16_t)(int8_t)(uint8_t)(b.index - a.index) * STEP_SCALE);
+    const uint16_t dVal = (uint16_t)(((int16_t)b.value - a.value) * STEP_SCALE);
+
+    uint16_t end = (uint16_t)(start + ANCHOR_SPACING);
+    if (end > NUM_LEDS) end = NUM_LEDS;
+    for (uint16_t i = start; i < end; ++i) {
+      s_px[i].index = (uint8_t)(idx >> 8);
+      s_px[i].value = (uint8_t)(val >> 8);
+      idx += dIdx;
+      val += dVal;
+    }
+  }
+
+  // Anchor v has been computed: fill the segment that ends on it.
+  static inline void placeAnchor(uint16_t v, const Pixel &p, Pixel &prev) {
+    if (v > 0) rampSegment((uint16_t)((v - 1) * ANCHOR_SPACING), prev, p);
+    const uint16_t i = (uint16_t)(v * ANCHOR_SPACING);
+    if (v == ANCHOR_COUNT - 1 && i < NUM_LEDS) s_px[i] = p;
+    prev = p;
+  }
+
+  static inline void beginSpans() {
+    s_spanCount = 0;
+  }
+
+  // Append a run. Runs beyond MAX_SPANS are ignored; output stops at NUM_LEDS.
+  static inline void addSpan(const CRGB &c, uint8_t length) {
+    if (s_spanCount >= MAX_SPANS) return;
+    s_spans[s_spanCount].colour = c;
+    s_spans[s_spanCount].length = length;
+    s_spanCount++;
+  }
+
+  // Colour of one pixel from the brightness-scaled palette table. This runs
+  // between pixels with the line low: WS2812B parts latch after ~5-6 us
+  // low, so it must stay a few us at most (~30 AVR cycles: a table lookup,
+  // a half-step average when index falls between entries, three scale8 for
+  // the value). LED_STRIP_DEBUG times it at boot.
+  static inline CRGB expandPixel(const CRGB *table, const Pixel p) {
+    const uint8_t e = (uint8_t)(p.index >> 4);
+    CRGB c = table[e];
+    if (p.index & 0x08) {
+      const CRGB &n = table[(e + 1) & 15];
+      c.r = (uint8_t)(((uint16_t)c.r + n.r) >> 1);
+      c.g = (uint8_t)(((uint16_t)c.g + n.g) >> 1);
+      c.b = (uint8_t)(((uint16_t)c.b + n.b) >> 1);
+    }
+    c.r = scale8(c.r, p.value);
+    c.g = scale8(c.g, p.value);
+    c.b = scale8(c.b, p.value);
+    return c;
+  }
+
+  // Palette entries scaled by brightness, for expandPixel().
+  static void buildTable(CRGB *table, uint8_t brightness) {
+    for (uint8_t e = 0; e < 16; ++e) {
+      table[e] = ColorFromPalette(*s_palette, (uint8_t)(e << 4), brightness, NOBLEND);
     }
   }
 
-  static inline void featherEdges(uint8_t amount) {
-    if (amount == 0) return;
-    blur1d(s_leds, NUM_LEDS, amount);
+  // Theme crossfade: the outgoing frame as one colour per SIG_BLOCK LEDs,
+  // mixed under the new theme's frames by Themes::blend(). The mix is a
+  // qadd8 of two pre-scaled colours per pixel, so the line-low gap grows by
+  // a few cycles only.
+  static inline uint8_t blockLength(uint8_t b) {
+    const uint16_t first = (uint16_t)b * SIG_BLOCK;
+    return (first + SIG_BLOCK <= NUM_LEDS) ? SIG_BLOCK : (uint8_t)(NUM_LEDS - first);
+  }
+
+  static inline CRGB scaled(CRGB c, uint8_t scale) {
+    c.r = scale8(c.r, scale);
+    c.g = scale8(c.g, scale);
+    c.b = scale8(c.b, scale);
+    return c;
+  }
+
+  // Snapshot what the strip shows (already a mix if a crossfade was running).
+  // Called on theme entry, before the new theme takes the arena and palette.
+  static void captureFade() {
+    CRGB table[16];
+    buildTable(table, 255);
+    uint8_t k = 0;
+    uint16_t spanEnd = (s_spanCount > 0) ? s_spans[0].length : 0;
+    for (uint8_t b = 0; b < SIG_BLOCKS; ++b) {
+      const uint16_t mid = (uint16_t)(b * SIG_BLOCK + blockLength(b) / 2);
+      CRGB now = CRGB::Black;
+      if (s_spanCount > 0) {
+        while (k < s_spanCount && mid >= spanEnd) {
+          if (++k < s_spanCount) spanEnd = (uint16_t)(spanEnd + s_spans[k].length);
+        }
+        if (k < s_spanCount) now = s_spans[k].colour;
+      } else {
+        now = expandPixel(table, s_px[mid]);
+      }
+      s_fadeFrom[b] = (s_shownBlend == 255) ? now : blend(s_fadeFrom[b], now, s_shownBlend);
+    }
+  }
+
+  // Frame power mixed with the snapshot's by weight.
+  static uint32_t mixPower(uint32_t frame_mW, uint8_t weight) {
+    uint32_t from_mW = 0;
+    for (uint8_t b = 0; b < SIG_BLOCKS; ++b) {
+      from_mW += calculate_unscaled_power_mW(&s_fadeFrom[b], 1) * blockLength(b);
+    }
+    return (frame_mW * weight + from_mW * (uint8_t)(255 - weight)) >> 8;
+  }
+
+  // Snapshot scaled to its share of the pushed frame (before begin()).
+  static void buildFadeFrom(CRGB *from, uint8_t brightness, uint8_t weight) {
+    const uint8_t scale = scale8(brightness, (uint8_t)(255 - weight));
+    for (uint8_t b = 0; b < SIG_BLOCKS; ++b) from[b] = scaled(s_fadeFrom[b], scale);
+  }
+
+  // Span frames are a handful of bytes, so they are always sent whole.
+  static void showSpans(uint8_t weight) {
+    FrameSignature sig;
+    sig.add(s_spanCount);
+    sig.add(s_spans, (uint16_t)(s_spanCount * sizeof(Span)));
+
+    uint32_t unscaled_mW = 0;
+    uint16_t total = 0;
+    for (uint8_t k = 0; k < s_spanCount; ++k) {
+      unscaled_mW += calculate_unscaled_power_mW(&s_spans[k].colour, 1) * s_spans[k].length;
+      total = (uint16_t)(total + s_spans[k].length);
+    }
+
+    sig.add(weight);
+    if (weight != 255) unscaled_mW = mixPower(unscaled_mW, weight);
+
+    uint8_t brightness;
+    if (!LedOutput::needsPush(LedOutput::SURFACE_STRIP, sig, unscaled_mW, brightness)) return;
+
+    // The block signatures no longer describe what is on the strip.
+    s_pushedValid = false;
+    s_shownBlend = weight;
+
+    if (weight != 255) {
+      CRGB from[SIG_BLOCKS];
+      buildFadeFrom(from, brightness, weight);
+      CRGB spanOut[MAX_SPANS];
+      const uint8_t spanScale = scale8(brightness, weight);
+      for (uint8_t k = 0; k < s_spanCount; ++k) spanOut[k] = scaled(s_spans[k].colour, spanScale);
+
+      uint8_t k = 0;
+      uint16_t spanLeft = s_spans[0].length;
+      CRGB c = spanOut[0];
+      uint8_t b = 0;
+      uint8_t inBlock = 0;
+      s_out.begin();
+      for (uint16_t i = 0; i < NUM_LEDS; ++i) {
+        while (spanLeft == 0) {   // next run; past the last one the tail is black
+          if (++k < s_spanCount) {
+            spanLeft = s_spans[k].length;
+            c = spanOut[k];
+          } else {
+            spanLeft = NUM_LEDS;
+            c = CRGB::Black;
+          }
+        }
+        spanLeft--;
+        const CRGB &o = from[b];
+        s_out.pixel(qadd8(c.r, o.r), qadd8(c.g, o.g), qadd8(c.b, o.b));
+        if (++inBlock == SIG_BLOCK) {
+          inBlock = 0;
+          b++;
+        }
+      }
+      s_out.end();
+      return;
+    }
+
+    uint16_t left = NUM_LEDS;
+    s_out.begin();
+    for (uint8_t k = 0; k < s_spanCount && left > 0; ++k) {
+      const uint8_t r = scale8(s_spans[k].colour.r, brightness);
+      const uint8_t g = scale8(s_spans[k].colour.g, brightness);
+      const uint8_t b = scale8(s_spans[k].colour.b, brightness);
+      uint16_t n = s_spans[k].length;
+      if (n > left) n = left;
+      left = (uint16_t)(left - n);
+      while (n--) s_out.pixel(r, g, b);
+    }
+    // Short descriptions leave the tail black.
+    while (left--) s_out.pixel(0, 0, 0);
+    s_out.end();
+
+    if (total != NUM_LEDS) DBG_LED_STRIP2(F("[STRIP] Span total: "), total);
+  }
+
+  // Push the strip if the frame (or its power-limited brightness) changed,
+  // sending only the prefix up to the last changed block.
+  // weight: Themes::blend() for this frame (255 = no crossfade).
+  static void show(uint8_t weight) {
+    if (s_spanCount > 0) {
+      showSpans(weight);
+      return;
+    }
+
+    uint16_t blockSig[SIG_BLOCKS];
+    FrameSignature sig;
+    for (uint8_t b = 0; b < SIG_BLOCKS; ++b) {
+      const uint16_t first = (uint16_t)b * SIG_BLOCK;
+      const uint16_t count = (first + SIG_BLOCK <= NUM_LEDS) ? SIG_BLOCK : (uint16_t)(NUM_LEDS - first);
+      FrameSignature bs;
+      bs.add(&s_px[first], (uint16_t)(count * sizeof(Pixel)));
+      blockSig[b] = bs.value();
+      sig.add(bs.a);
+      sig.add(bs.b);
+    }
+    sig.add(&s_palette, sizeof(s_palette));
+
+    // Power estimate: per-pixel value scales the power of its palette entry
+    // (blend with the neighbouring entry ignored).
+    const CRGB black = CRGB::Black;
+    const uint16_t dark_mW = (uint16_t)calculate_unscaled_power_mW(&black, 1);
+    uint32_t unscaled_mW = (uint32_t)dark_mW * NUM_LEDS;
+    {
+      uint16_t entry_mW[16];
+      for (uint8_t e = 0; e < 16; ++e) {
+        const CRGB entry = ColorFromPalette(*s_palette, (uint8_t)(e << 4), 255, NOBLEND);
+        entry_mW[e] = (uint16_t)(calculate_unscaled_power_mW(&entry, 1) - dark_mW);
+      }
+      for (uint16_t i = 0; i < NUM_LEDS; ++i) {
+        unscaled_mW += ((uint32_t)entry_mW[s_px[i].index >> 4] * s_px[i].value) >> 8;
+      }
+    }
+
+    sig.add(weight);
+    if (weight != 255) unscaled_mW = mixPower(unscaled_mW, weight);
+
+    uint8_t brightness;
+    if (!LedOutput::needsPush(LedOutput::SURFACE_STRIP, sig, unscaled_mW, brightness)) return;
+
+    // A brightness, palette or crossfade change touches every lit LED: send
+    // the whole strip.
+    uint16_t pushLen = NUM_LEDS;
+    if (s_pushedValid && brightness == s_pushedBrightness && s_palette == s_pushedPalette &&
+        weight == 255 && s_shownBlend == 255 && s_truncatedPushes < FULL_PUSH_EVERY) {
+      uint8_t changed = SIG_BLOCKS;
+      while (changed > 0 && blockSig[changed - 1] == s_pushedBlockSig[changed - 1]) changed--;
+      pushLen = (uint16_t)changed * SIG_BLOCK;
+      if (pushLen > NUM_LEDS) pushLen = NUM_LEDS;
+      s_truncatedPushes++;
+    } else {
+      s_truncatedPushes = 0;
+    }
+
+    for (uint8_t b = 0; b < SIG_BLOCKS; ++b) s_pushedBlockSig[b] = blockSig[b];
+    s_pushedBrightness = brightness;
+    s_pushedPalette = s_palette;
+    s_pushedValid = true;
+    s_shownBlend = weight;
+
+    if (pushLen == 0) return;
+
+    // The table is built before interrupts go off; inside the frame each
+    // pixel is only a lookup.
+    CRGB table[16];
+    if (weight != 255) {
+      CRGB from[SIG_BLOCKS];
+      buildFadeFrom(from, brightness, weight);
+      buildTable(table, scale8(brightness, weight));
+      uint8_t b = 0;
+      uint8_t inBlock = 0;
+      s_out.begin();
+      for (uint16_t i = 0; i < pushLen; ++i) {
+        const CRGB c = expandPixel(table, s_px[i]);
+        const CRGB &o = from[b];
+        s_out.pixel(qadd8(c.r, o.r), qadd8(c.g, o.g), qadd8(c.b, o.b));
+        if (++inBlock == SIG_BLOCK) {
+          inBlock = 0;
+          b++;
+        }
+      }
+      s_out.end();
+      return;
+    }
+    buildTable(table, brightness);
+
+    s_out.begin();
+    for (uint16_t i = 0; i < pushLen; ++i) {
+      const CRGB c = expandPixel(table, s_px[i]);
+      s_out.pixel(c.r, c.g, c.b);
+    }
+    s_out.end();
   }
 
   // ------------------------------------------------------------
   // Renderers
   // ------------------------------------------------------------
 
-  // Folder 1: Party / rainbow marble-ish (block-rendered x4 + feather)
-  static inline void renderPartyMarbleStrip_Block4() {
-    s_partyTime += 3;
-    const uint16_t virtualCount = (uint16_t)((NUM_LEDS + (BLOCK_SIZE - 1)) / BLOCK_SIZE);
-    const uint16_t NOISE_SCALE = 380;
+  // Folder 1: Party / rainbow marble-ish (anchors every 4 LEDs, ramped between)
+  void renderPartyMarble() {
+    s_spanCount = 0;
+    NoiseField::prepare(NoiseField::THEME_PARTY);
+    uint8_t noise[ANCHOR_COUNT];
+    NoiseField::stripRows(true, (uint8_t)ANCHOR_COUNT, noise, nullptr, nullptr);
     const uint8_t BRIGHT = 255;
-    const uint8_t swirlA = beatsin8(7, 0, 255);
-    const uint8_t swirlB = beatsin8(13, 0, 255);
-
-    for (uint16_t v = 0; v < virtualCount; ++v) {
-      const uint16_t x = (uint16_t)(v * NOISE_SCALE);
-      const uint16_t z = (uint16_t)(s_partyTime + (swirlA / 2) + (swirlB / 3));
-      const uint8_t n = inoise8(x, z);
-      const uint8_t index = qadd8(n, 30);
-      const CRGB c = ColorFromPalette(PartyColors_p, index, BRIGHT);
-      const uint16_t i = (uint16_t)(v * BLOCK_SIZE);
-      fillBlock(i, c);
-    }
 
-    featherEdges(FEATHER_PARTY);
+    Pixel prev;
+    for (uint16_t v = 0; v < ANCHOR_COUNT; ++v) {
+      const uint8_t index = qadd8(noise[v], 30);
+      const Pixel p = { index, BRIGHT };
+      placeAnchor(v, p, prev);
+    }
   }
 
-  // Folder 2: Slow ember-bed marble, darker lows, more blur, no white
-  static inline void renderEmberMarbleSlow_Block4() {
-    s_emberTime += 1;
-    s_emberDriftX += 1;
-
-    const uint16_t virtualCount = (uint16_t)((NUM_LEDS + (BLOCK_SIZE - 1)) / BLOCK_SIZE);
-
-    const uint16_t SCALE_COARSE = 360;
-    const uint16_t SCALE_FINE   = 120;
+  // Folder 2: Slow ember-bed marble, darker lows, soft ramps, no white.
+  // fine = false (QUALITY_LOW) drops the fine noise octave.
+  static void renderEmbers(bool fine) {
+    s_spanCount = 0;
+    // The matrix rows are not read here: the fine one is left to the matrix.
+    NoiseField::prepare(NoiseField::THEME_FIRE, false);
+
+    // Colour from the coarse and fine ember octaves, brightness from its own
+    // octave. Without the fine layer colour is the coarse octave alone.
+    uint8_t coarse[ANCHOR_COUNT];
+    uint8_t detail[ANCHOR_COUNT];
+    uint8_t bright[ANCHOR_COUNT];
+    NoiseField::stripRows(fine, (uint8_t)ANCHOR_COUNT, coarse, detail, bright);
     const uint8_t  BLEND_FINE   = 80;
 
-    const uint16_t SCALE_BRIGHT = 220;
-
     const uint8_t IDX_MIN = 6;
     const uint8_t IDX_MAX = 110;
 
     const uint8_t VAL_MIN = 4;
     const uint8_t VAL_MAX = 210;
 
-    const uint8_t shimmer = beatsin8(4, 0, 18);
+    const uint8_t shimmer = PhaseClock::beatsin8(4, 0, 18);
 
-    const uint8_t POP_PROB = 3;
+    const uint8_t POP_PROB = 3; // per anchor per nominal frame
     const uint8_t POP_ADD_VAL_MIN = 10;
     const uint8_t POP_ADD_VAL_MAX = 45;
-    const uint8_t POP_WARM_R = 22;
-    const uint8_t POP_WARM_G = 8;
-
-    for (uint16_t v = 0; v < virtualCount; ++v) {
-      const uint16_t xC1 = (uint16_t)((uint32_t)v * SCALE_COARSE + (uint16_t)(s_emberDriftX & 0xFFFF));
-      const uint16_t xC2 = (uint16_t)((uint32_t)v * SCALE_FINE   + (uint16_t)((s_emberDriftX * 3) & 0xFFFF));
-      const uint8_t nCoarse = inoise8(xC1, (uint16_t)(s_emberTime));
-      const uint8_t nFine   = inoise8(xC2, (uint16_t)(s_emberTime + 53));
-      uint8_t nColor = lerp8by8(nCoarse, nFine, BLEND_FINE);
+    const uint8_t POP_WARM_IDX = 6; // warmer = further along HeatColors_p
+    const uint16_t popScaled = (uint16_t)(((uint32_t)POP_PROB * PhaseClock::framesQ8(s_frameDtMs)) >> 8);
+    const uint8_t popProb = (popScaled > 255) ? 255 : (uint8_t)popScaled;
+
+    Pixel prev;
+    for (uint16_t v = 0; v < ANCHOR_COUNT; ++v) {
+      uint8_t nColor = fine ? lerp8by8(coarse[v], detail[v], BLEND_FINE) : coarse[v];
       nColor = ease8InOutQuad(nColor);
 
-      const uint16_t xB = (uint16_t)((uint32_t)v * SCALE_BRIGHT + (uint16_t)((s_emberDriftX * 5) & 0xFFFF));
-      uint8_t nBright = inoise8(xB, (uint16_t)(s_emberTime + 97));
-      nBright = ease8InOutQuad(nBright);
+      const uint8_t nBright = ease8InOutQuad(bright[v]);
 
       const uint8_t idx = (uint8_t)map(nColor, 0, 255, IDX_MIN, IDX_MAX);
 
       uint8_t val = (uint8_t)map(nBright, 0, 255, VAL_MIN, VAL_MAX);
       val = qadd8(val, shimmer);
 
-      CRGB c = ColorFromPalette(HeatColors_p, idx, val, LINEARBLEND);
+      Pixel p = { idx, val };
 
-      if (random8() < POP_PROB) {
+      if (random8() < popProb) {
         const uint8_t addV = random8(POP_ADD_VAL_MIN, POP_ADD_VAL_MAX);
-        const uint8_t newV = qadd8(val, addV);
-        c = ColorFromPalette(HeatColors_p, idx, newV, LINEARBLEND);
-        c.r = qadd8(c.r, POP_WARM_R);
-        c.g = qadd8(c.g, POP_WARM_G);
+        p.value = qadd8(val, addV);
+        p.index = (uint8_t)(idx + POP_WARM_IDX);
       }
 
-      const uint16_t i = (uint16_t)(v * BLOCK_SIZE);
-      fillBlock(i, c);
+      placeAnchor(v, p, prev);
+    }
+  }
+
+  void renderEmberMarble() {
+    renderEmbers(FrameScheduler::quality(LedOutput::SURFACE_STRIP) == FrameScheduler::QUALITY_FULL);
+  }
+
+#if (DEBUG == 1) && (NOISE_BENCH == 1)
+  // Ember frame with the noise field recomputed every frame (the frame that
+  // pays for the field is the one the governor's budget has to cover).
+  void benchmarkEmbers() {
+    static const uint8_t PASSES = 16;
+    uint32_t us[2];
+    for (uint8_t fine = 0; fine < 2; ++fine) {
+      const uint32_t t0 = micros();
+      for (uint8_t p = 0; p < PASSES; ++p) {
+        NoiseField::invalidate();
+        renderEmbers(fine != 0);
+      }
+      us[fine] = (micros() - t0) / PASSES;
     }
+    clear();
+    debug(F("[NOISE] ember strip us full/low: "));
+    debug(us[1]); debug(F(" / ")); debugln(us[0]);
+  }
+#endif
 
-    featherEdges(FEATHER_EMBER);
+  // EffectVM sink: no per-element storage, every block becomes a run.
+  static void runSpan(uint16_t first, uint16_t length, const CRGB &colour) {
+    (void)first;
+    addSpan(colour, (uint8_t)length);
+  }
+
+  static const EffectVM::Sink s_spanSink = { NUM_LEDS, nullptr, runSpan };
+
+  void runProgram(const uint8_t *program) {
+    beginSpans();
+    EffectVM::run(program, s_spanSink);
+    if (s_spanCount == 0) addSpan(CRGB::Black, (uint8_t)NUM_LEDS);
+  }
+
+  // Baked themes play their keyframes (same spans, no interpretation).
+  void renderProgram() {
+    if (s_clipValid) {
+      beginSpans();
+      Playback::play(s_clip, s_spanSink);
+    } else {
+      runProgram(Themes::current().stripProgram);
+    }
   }
 
   // Folder 3: Christmas half pulse
   // FIX: Phase-align colours with matrix:
   // Matrix: left RED = brightA (phase 0), right GREEN = brightB (phase 128). [2](https://teamtelstra-my.sharepoint.com/personal/jeff_c_cornwell_team_telstra_com/Documents/Microsoft%20Copilot%20Chat%20Files/LedMatrix.cpp)
   // Strip: keep left GREEN / right RED, but ensure GREEN uses brightB and RED uses brightA.
-  static inline void renderXmasHalfPulseStrip() {
+  void renderXmasHalfPulse() {
     const uint8_t MIN_BRIGHT = 30;
     const uint8_t MAX_BRIGHT = 255;
     const uint8_t BPM = 18;
 
-    const uint8_t brightA = beatsin8(BPM, MIN_BRIGHT, MAX_BRIGHT, 0, 0);
-    const uint8_t brightB = beatsin8(BPM, MIN_BRIGHT, MAX_BRIGHT, 0, 128);
+    const uint8_t brightA = PhaseClock::beatsin8(BPM, MIN_BRIGHT, MAX_BRIGHT, 0);
+    const uint8_t brightB = PhaseClock::beatsin8(BPM, MIN_BRIGHT, MAX_BRIGHT, 128);
 
     const uint16_t half = (uint16_t)(NUM_LEDS / 2);
     const uint16_t split = (half + 2 <= NUM_LEDS) ? (uint16_t)(half + 2) : half;
 
-    for (uint16_t i = 0; i < NUM_LEDS; ++i) {
-      if (i < split) {
-        // LEFT: GREEN (match matrix GREEN phase => brightB)
-        s_leds[i] = CRGB(0, brightB, 0);
-      } else {
-        // RIGHT: RED (match matrix RED phase => brightA)
-        s_leds[i] = CRGB(brightA, 0, 0);
-      }
-    }
+    // Two runs: LEFT GREEN (matrix GREEN phase => brightB),
+    // RIGHT RED (matrix RED phase => brightA).
+    beginSpans();
+    addSpan(CRGB(0, brightB, 0), (uint8_t)split);
+    addSpan(CRGB(brightA, 0, 0), (uint8_t)(NUM_LEDS - split));
   }
 
   // Folder 4: Solid spooky fog (your current setup)
-  static inline void renderSpookySolidStrip() {
+  void renderSpookyFog() {
     const uint8_t pulse = (s_externalSpookyBreath != 0xFF) ? s_externalSpookyBreath : 90;
 
     // Hue 100 = your chosen "more lime, less aqua"
@@ -191,75 +596,113 @@ namespace LedStrip {
     CRGB fog = fogHSV;
     fog.nscale8_video(pulse);
 
-    fill_solid(s_leds, NUM_LEDS, fog);
-    featherEdges(FEATHER_SPOOKY);
+    // One uniform run; blurring a uniform colour changes nothing.
+    beginSpans();
+    addSpan(fog, (uint8_t)NUM_LEDS);
   }
 
   // ------------------------------------------------------------
   // Public API
   // ------------------------------------------------------------
   void begin() {
-    FastLED.addLeds<WS2812B, DATA_PIN, COLOR_ORDER>(s_leds, NUM_LEDS);
+    s_out.init();
     clear();
-    // One-time show at boot so strip comes up in a known state.
-    // (Runtime updates remain owned by LedMatrix::update().)
-    FastLED.show();
+    // One-time push at boot so the strip comes up in a known state.
+    LedOutput::invalidate(LedOutput::SURFACE_STRIP);
+    s_pushedValid = false;
+    show(255);
 
     s_lastFrameMs = millis();
     s_isOffLatched = false;
-    s_lastFolder = 255;
+    s_lastTheme = 0xFF;
 
-    s_partyTime = 0;
-    s_emberTime = 0;
-    s_emberDriftX = 0;
     s_externalSpookyBreath = 0xFF;
 
     DBG_LED_STRIP2(F("[STRIP] Ready: "), NUM_LEDS);
+#if (DEBUG == 1) && (LED_STRIP_DEBUG == 1)
+    // Per-pixel expansion time = the extra low time between pixels on the
+    // wire (us per NUM_LEDS pixels, worst case: every pixel half-step).
+    {
+      CRGB table[16];
+      buildTable(table, 255);
+      volatile uint8_t sink = 0;
+      const uint32_t t0 = micros();
+      for (uint16_t i = 0; i < NUM_LEDS; ++i) {
+        const Pixel p = { (uint8_t)(i | 0x08), (uint8_t)i };
+        const CRGB c = expandPixel(table, p);
+        sink ^= (uint8_t)(c.r ^ c.g ^ c.b);
+      }
+      (void)sink;
+      DBG_LED_STRIP2(F("[STRIP] Expand us/frame: "), micros() - t0);
+    }
+#endif
   }
 
-  void update(uint8_t folder, bool lightsOn) {
-    // Off conditions: MATRIX_OFF (lightsOn=false) or folder==99
-    if (!lightsOn || folder == 99) {
+  void update(bool lightsOn) {
+    const Themes::Theme &theme = Themes::current();
+
+    // Off conditions: MATRIX_OFF (lightsOn=false) or a dark theme (between
+    // stations) once the crossfade into it has finished.
+    const bool dark = theme.renderStrip == nullptr;
+    if (!lightsOn || (dark && Themes::blend() == 255)) {
       if (!s_isOffLatched) {
+        // Pushed once and then never again: always send all of it.
         clear();
+        LedOutput::invalidate(LedOutput::SURFACE_STRIP);
+        s_pushedValid = false;
+        show(255);
         s_isOffLatched = true;
-        // No FastLED.show() here; LedMatrix::update() will push the cleared state.
+        s_lastTheme = 0xFF;   // clear() wrote over the arena: re-enter on return
       }
-      s_lastFolder = folder;
       return;
     }
 
-    // Coming back on
+    // Coming back on: render at once, even under FRAME_HOLD (the arena was
+    // cleared).
     if (s_isOffLatched) {
       s_isOffLatched = false;
-      s_lastFrameMs = 0; // allow immediate render
+      s_frameOwed = true;
     }
 
-    // Gentle deterministic resets on folder change (as before)
-    if (folder != s_lastFolder) {
-      s_lastFolder = folder;
-      if (folder == 1) {
-        s_partyTime = 0;
-      } else if (folder == 2) {
-        s_emberTime = 0;
-      }
-      // Folder 3 and 4 do not require time resets in this implementation
+    // Theme entry (noise time is owned by NoiseField)
+    if (Themes::currentId() != s_lastTheme) {
+      s_lastTheme = Themes::currentId();
+      captureFade();
+      enterTheme(theme);
     }
 
-    const uint32_t now = millis();
-    if ((uint32_t)(now - s_lastFrameMs) < FRAME_INTERVAL_MS) return;
-    s_lastFrameMs = now;
-
-    switch (folder) {
-      case 1: renderPartyMarbleStrip_Block4(); break;
-      case 2: renderEmberMarbleSlow_Block4(); break;
-      case 3: renderXmasHalfPulseStrip(); break;
-      case 4: renderSpookySolidStrip(); break; // ✅ FIX: actually render folder 4
-      default: clear(); break;
+    const uint32_t now = PhaseClock::nowMs();
+    uint16_t interval = FrameScheduler::interval(LedOutput::SURFACE_STRIP);
+    if (interval < s_frameIntervalMs) interval = s_frameIntervalMs;
+    if (!s_frameOwed && (s_frameIntervalMs == FRAME_HOLD ||
+                         (uint32_t)(now - s_lastFrameMs) < interval)) {
+      // Between frames (or held): a palette swap or a brightness change is
+      // re-expanded from the held buffer.
+      if (s_paletteChanged || LedOutput::getBrightness() != s_shownBrightness) {
+        s_paletteChanged = false;
+        s_shownBrightness = LedOutput::getBrightness();
+        show(Themes::blend());
+      }
+      return;
     }
-
-    // IMPORTANT: Do not call FastLED.show() here.
-    // LedMatrix::update() already calls FastLED.show() and will output both controllers.
+    s_frameOwed = false;
+    s_frameDtMs = PhaseClock::elapsed(s_lastFrameMs);
+    s_paletteChanged = false;
+    const uint16_t lateMs = (s_frameDtMs > interval) ? (uint16_t)(s_frameDtMs - interval) : 0;
+    const uint32_t frameT0 = micros();
+
+    if (dark) clear();
+    else theme.renderStrip();
+    const uint32_t renderUs = micros() - frameT0;
+
+    s_shownBrightness = LedOutput::getBrightness();
+    show(Themes::blend());
+
+    // Render and push cost feed the frame rate and quality choice.
+    const uint32_t frameUs = micros() - frameT0;
+    FrameScheduler::recordFrame(LedOutput::SURFACE_STRIP, lateMs,
+                                (renderUs > 0xFFFF) ? 0xFFFF : (uint16_t)renderUs,
+                                (frameUs > 0xFFFF) ? 0xFFFF : (uint16_t)frameUs);
   }
 
 } // namespace LedStrip
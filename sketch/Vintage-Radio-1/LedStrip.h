@@ -11,17 +11,24 @@ WS2812B LED Strip (90 LEDs) - Lightweight Module
 ============================================================
 Goals:
  - Minimal SRAM/CPU impact (Nano-friendly)
- - Avoid FastLED.show() duplication:
-   The main loop should call LedStrip::update() BEFORE LedMatrix::update().
-   LedMatrix::update() already calls FastLED.show(), which updates ALL controllers.
+ - Independent refresh: the strip has its own Ws2812::Writer on its own pin,
+   its own frame rate and its own dirty check (LedOutput). It never waits for,
+   or forces, a matrix push.
 
-Current behaviour (preserved):
- - Off (cleared/latched) when lightsOn==false OR folder==99
- - Non-blocking update, frame-throttled
- - update() does NOT call FastLED.show()
+Behaviour:
+ - Renders the theme selected in Themes (renderer, palette, frame rate and
+   state size come from the theme table)
+ - Off (cleared/latched) when lightsOn==false OR the theme has no strip
+   renderer (between stations, after the crossfade into it)
+ - A theme change crossfades from a 15-block RGB snapshot of the previous
+   frame (Themes::blend())
+ - Non-blocking update, frame-throttled at a per-folder rate chosen by
+   FrameScheduler (slow themes render less often)
+ - update() pushes the strip itself when the rendered frame changed
+ - Folders 1, 2 are stored as palette index + value (2 bytes/LED) and
+   expanded to RGB while streaming
 
-New behaviour (this task):
- - Folder-based theming:
+Folder-based theming:
    1: Party / rainbow marble vibe
    2: Fire vibe
    3: Christmas half pulse (left red, right green)
@@ -34,18 +41,60 @@ Spooky sync:
 */
 
 namespace LedStrip {
-  // Initialize FastLED controller for the strip and clear it.
+  static const uint16_t NUM_LEDS = Config::STRIP_NUM_LEDS;
+
+  // Prefix-truncated push granularity (LEDs per change-detection block).
+  static const uint8_t SIG_BLOCK = 6;
+  static const uint8_t SIG_BLOCKS = (uint8_t)((NUM_LEDS + SIG_BLOCK - 1) / SIG_BLOCK);
+
+  // Per-theme state of the index/value (marble) themes: the frame itself,
+  // palette index + value per LED, and the block signatures of the last push.
+  struct Pixel {
+    uint8_t index;
+    uint8_t value;
+  };
+  struct MarbleState {
+    Pixel    px[NUM_LEDS];
+    uint16_t pushedBlockSig[SIG_BLOCKS];
+  };
+
+  // Initialize the strip output and clear it.
   void begin();
 
-  // Non-blocking update (does NOT call FastLED.show()).
-  // folder: 1..4 normal, 99 = off
+  // Non-blocking update of the selected theme; renders at the strip frame
+  // rate and pushes the strip only when the frame changed.
   // lightsOn: false = off
-  void update(uint8_t folder, bool lightsOn);
+  void update(bool lightsOn);
+
+  // Theme renderers (registered in the Themes table). renderProgram() runs
+  // the theme's EffectVM program as span runs. renderXmasHalfPulse() is the
+  // native version of a program in the table, kept as the VM_BENCH reference.
+  void renderProgram();
+  void runProgram(const uint8_t *program);
+  void renderPartyMarble();
+  void renderEmberMarble();
+  void renderXmasHalfPulse();
+  void renderSpookyFog();
 
-  // Clear the strip buffer to black (does not call FastLED.show()).
+  // Clear the strip buffer to black (does not push).
   void clear();
 
+  // Swap the palette used by the index/value themes (folders 1, 2). Applied at
+  // the next update() without re-rendering; a theme change restores the
+  // theme palette.
+  void setPalette(const TProgmemRGBPalette16 &palette);
+
   // Provide an external breath brightness (0..255) used by Folder 4 renderer.
   // Pass 0xFF to release and use internal fallback behaviour (if any).
   void setSpookyBreath(uint8_t pulse);
+
+  // Slow the frame rate down (same meaning as LedMatrix::setFrameInterval()).
+  // 0 = scheduled rate only, FRAME_HOLD = keep the last frame.
+  static const uint16_t FRAME_HOLD = 0xFFFF;
+  void setFrameInterval(uint16_t ms);
+
+#if (DEBUG == 1) && (NOISE_BENCH == 1)
+  // Print the ember render time at both quality levels (render budget).
+  void benchmarkEmbers();
+#endif
 } // namespace LedStrip
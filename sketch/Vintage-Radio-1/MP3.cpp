@@ -1,6 +1,7 @@
 
 #include "MP3.h"
 #include "Config.h"
+#include "SerialBus.h"
 #include <Arduino.h>
 #include <SoftwareSerial.h>
 #include <avr/pgmspace.h>
@@ -21,6 +22,7 @@ SRAM optimization:
 static SoftwareSerial mp3Serial(Config::PIN_MP3_RX, Config::PIN_MP3_TX);
 
 #define MP3_ONLINE_TIMEOUT_MS 5000UL
+#define MP3_REPLY_WINDOW_MS 250
 
 static uint8_t volume = 30;
 
@@ -90,7 +92,7 @@ static void logTxFrame_RAM(const uint8_t *cmd, uint8_t len) {
 
 static void sendCommand_P(const uint8_t *cmdP, uint8_t len) {
   logTxFrame_P(cmdP, len);
-  mp3Serial.listen();
+  SerialBus::claim(SerialBus::LINK_MP3, 0);
   for (uint8_t i = 0; i < len; ++i) {
     mp3Serial.write(pgm_read_byte(&cmdP[i]));
   }
@@ -99,7 +101,7 @@ static void sendCommand_P(const uint8_t *cmdP, uint8_t len) {
 
 static void sendCommand_RAM(const uint8_t *cmd, uint8_t len) {
   logTxFrame_RAM(cmd, len);
-  mp3Serial.listen();
+  SerialBus::claim(SerialBus::LINK_MP3, 0);
   mp3Serial.write(cmd, len);
   delay(20);
 }
@@ -163,11 +165,17 @@ static bool checkMP3OnlineWithTimeout(unsigned long timeoutMs) {
   const unsigned long start = millis();
   while (millis() - start < timeoutMs) {
     sendCommand_P(CMD_CHECK_ONLINE, sizeof(CMD_CHECK_ONLINE));
-    delay(250);
-    if (mp3Serial.available()) {
-      while (mp3Serial.available()) (void)mp3Serial.read();
-      DBG_MP3(F("MP3: Online"));
-      return true;
+
+    // Hold the listener on the MP3 link until the status reply arrives.
+    SerialBus::claim(SerialBus::LINK_MP3, MP3_REPLY_WINDOW_MS);
+    while (SerialBus::inWindow(SerialBus::LINK_MP3)) {
+      if (mp3Serial.available()) {
+        delay(10); // let the rest of the reply frame land
+        while (mp3Serial.available()) (void)mp3Serial.read();
+        SerialBus::release(SerialBus::LINK_MP3);
+        DBG_MP3(F("MP3: Online"));
+        return true;
+      }
     }
   }
   DBG_MP3(F("MP3: Offline (timeout)"));
@@ -189,8 +197,8 @@ uint8_t MP3::getDesiredFolder() {
 }
 
 void MP3::init() {
-  mp3Serial.begin(Config::MP3_BAUD);
-  mp3Serial.listen();
+  SerialBus::attach(SerialBus::LINK_MP3, mp3Serial);
+  SerialBus::begin(SerialBus::LINK_MP3, Config::MP3_BAUD);
   DBG_MP3(F("MP3: Control Ready"));
 
   s_mp3Online = checkMP3OnlineWithTimeout(MP3_ONLINE_TIMEOUT_MS);
@@ -210,8 +218,8 @@ void MP3::nextTrack() {
 void MP3::tick() {
   if (!s_mp3Online) return;
 
-  // Drain RX (optional debug)
-  while (mp3Serial.available()) {
+  // Drain RX (optional debug). Only meaningful while MP3 owns the listener.
+  while (SerialBus::isListening(SerialBus::LINK_MP3) && mp3Serial.available()) {
     byte incoming = mp3Serial.read();
     if (DEBUG == 1 && MP3_RX_DEBUG == 1) {
       debug(F("MP3 RX: "));
@@ -0,0 +1,75 @@
+// MatrixLayout.h
+#pragma once
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "Ws2812.h"
+
+/*
+ ============================================================
+ Matrix panel wiring (compile time)
+ ============================================================
+ Renderers only ever write columns[] (one colour per column); the panel's
+ wiring decides in which order those colours go out on the data line.
+ Panel<> turns Config::MATRIX_WIRING / MATRIX_MIRRORED into that order at
+ compile time: every test below is on template constants, so the chosen
+ wiring compiles to its own plain loop, with no lookup table and no
+ per-pixel mapping.
+
+  - COLUMNS: the wire walks one column (HEIGHT LEDs) after another. Each
+    column colour is scaled once and sent HEIGHT times.
+  - COLUMNS_SERPENTINE: the same stream; up/down direction inside a solid
+    column is invisible.
+  - ROWS (panel mounted sideways): the wire walks one row (WIDTH LEDs)
+    after another, so each row streams all columns.
+  - ROWS_SERPENTINE: as ROWS, every second row right to left.
+  - MIRRORED: column 0 is at the far end of each line.
+
+ Usage (inside a Ws2812 frame):
+   Panel<W, H>::stream(writer, columns, brightness);
+*/
+
+namespace MatrixLayout {
+
+  template <uint8_t WIDTH, uint8_t HEIGHT,
+            Config::MatrixWiring WIRING = Config::MATRIX_WIRING,
+            bool MIRRORED = Config::MATRIX_MIRRORED>
+  struct Panel {
+    static constexpr bool ROWS_FIRST =
+      (WIRING == Config::WIRING_ROWS || WIRING == Config::WIRING_ROWS_SERPENTINE);
+    static constexpr bool SERPENTINE = (WIRING == Config::WIRING_ROWS_SERPENTINE);
+
+    // Column of the LED at position step of wire line line (a column for
+    // column wiring, a row for row wiring).
+    static constexpr uint8_t column(uint8_t line, uint8_t step) {
+      return mirror(ROWS_FIRST ? ((SERPENTINE && (line & 1)) ? (uint8_t)(WIDTH - 1 - step) : step)
+                               : line);
+    }
+
+    // Send one frame of columns at brightness.
+    static inline void stream(Ws2812::Writer &out, const CRGB *columns, uint8_t brightness) {
+      if (ROWS_FIRST) {
+        for (uint8_t row = 0; row < HEIGHT; ++row) {
+          for (uint8_t step = 0; step < WIDTH; ++step) {
+            const CRGB &c = columns[column(row, step)];
+            out.pixel(scale8(c.r, brightness), scale8(c.g, brightness), scale8(c.b, brightness));
+          }
+        }
+      } else {
+        for (uint8_t line = 0; line < WIDTH; ++line) {
+          const CRGB &c = columns[column(line, 0)];
+          const uint8_t r = scale8(c.r, brightness);
+          const uint8_t g = scale8(c.g, brightness);
+          const uint8_t b = scale8(c.b, brightness);
+          for (uint8_t step = 0; step < HEIGHT; ++step) out.pixel(r, g, b);
+        }
+      }
+    }
+
+  private:
+    static constexpr uint8_t mirror(uint8_t col) {
+      return MIRRORED ? (uint8_t)(WIDTH - 1 - col) : col;
+    }
+  };
+
+}
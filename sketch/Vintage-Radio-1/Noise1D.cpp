@@ -0,0 +1,73 @@
+// Noise1D.cpp
+#include "Noise1D.h"
+#include <FastLED.h>
+
+namespace Noise1D {
+
+  // Ken Perlin's reference permutation (flash only).
+  static const uint8_t PROGMEM PERM[256] = {
+    151, 160, 137,  91,  90,  15, 131,  13, 201,  95,  96,  53, 194, 233,   7, 225,
+    140,  36, 103,  30,  69, 142,   8,  99,  37, 240,  21,  10,  23, 190,   6, 148,
+    247, 120, 234,  75,   0,  26, 197,  62,  94, 252, 219, 203, 117,  35,  11,  32,
+     57, 177,  33,  88, 237, 149,  56,  87, 174,  20, 125, 136, 171, 168,  68, 175,
+     74, 165,  71, 134, 139,  48,  27, 166,  77, 146, 158, 231,  83, 111, 229, 122,
+     60, 211, 133, 230, 220, 105,  92,  41,  55,  46, 245,  40, 244, 102, 143,  54,
+     65,  25,  63, 161,   1, 216,  80,  73, 209,  76, 132, 187, 208,  89,  18, 169,
+    200, 196, 135, 130, 116, 188, 159,  86, 164, 100, 109, 198, 173, 186,   3,  64,
+     52, 217, 226, 250, 124, 123,   5, 202,  38, 147, 118, 126, 255,  82,  85, 212,
+    207, 206,  59, 227,  47,  16,  58,  17, 182, 189,  28,  42, 223, 183, 170, 213,
+    119, 248, 152,   2,  44, 154, 163,  70, 221, 153, 101, 155, 167,  43, 172,   9,
+    129,  22,  39, 253,  19,  98, 108, 110,  79, 113, 224, 232, 178, 185, 112, 104,
+    218, 246,  97, 228, 251,  34, 242, 193, 238, 210, 144,  12, 191, 179, 162, 241,
+     81,  51, 145, 235, 249,  14, 239, 107,  49, 192, 214,  31, 181, 199, 106, 157,
+    184,  84, 204, 176, 115, 121,  50,  45, 127,   4, 150, 254, 138, 236, 205,  93,
+    222, 114,  67,  29,  24,  72, 243, 141, 128, 195,  78,  66, 215,  61, 156, 180,
+  };
+
+  static inline uint8_t perm(uint8_t i) {
+    return pgm_read_byte(&PERM[i]);
+  }
+
+  // Lattice column xi at time t: eased blend of its two time lattice values.
+  // Each column's time is shifted by a fraction of a cell taken from its
+  // hash, so the columns cross their time lattice (where the ease stops
+  // them) at different moments instead of the whole row stalling at once.
+  static inline uint8_t latticeColumn(uint8_t xi, uint16_t t) {
+    const uint8_t h = perm(xi);
+    const uint16_t tc = (uint16_t)(t + h);
+    const uint8_t ti = (uint8_t)(tc >> 8);
+    const uint8_t tf = ease8InOutQuad((uint8_t)(tc & 0xFF));
+    return lerp8by8(perm((uint8_t)(h + ti)), perm((uint8_t)(h + ti + 1)), tf);
+  }
+
+  void fillRow(uint8_t *row, uint8_t n, uint16_t x0, uint16_t step, uint16_t t) {
+    if (n == 0) return;
+
+    uint16_t x = x0;
+    uint8_t xi = (uint8_t)(x >> 8);
+    uint8_t c0 = latticeColumn(xi, t);
+    uint8_t c1 = latticeColumn((uint8_t)(xi + 1), t);
+
+    for (uint8_t i = 0; i < n; ++i) {
+      row[i] = lerp8by8(c0, c1, ease8InOutQuad((uint8_t)(x & 0xFF)));
+
+      x = (uint16_t)(x + step);
+      const uint8_t nxi = (uint8_t)(x >> 8);
+      if (nxi == xi) continue;
+      if (nxi == (uint8_t)(xi + 1)) {
+        c0 = c1;                                   // walked into the next cell
+      } else {
+        c0 = latticeColumn(nxi, t);
+      }
+      c1 = latticeColumn((uint8_t)(nxi + 1), t);
+      xi = nxi;
+    }
+  }
+
+  uint8_t sample(uint16_t x, uint16_t t) {
+    uint8_t v;
+    fillRow(&v, 1, x, 0, t);
+    return v;
+  }
+
+} // namespace Noise1D
@@ -0,0 +1,40 @@
+// Noise1D.h
+#pragma once
+#include <Arduino.h>
+
+/*
+ ============================================================
+ Fast 1D value noise (rows along x, evolving in time)
+ ============================================================
+ Cheap stand-in for FastLED's inoise8(x, t) when a whole row of samples is
+ needed at once (one per matrix column / strip anchor).
+
+  - Lattice values come from a 256-byte PROGMEM permutation table:
+      v(xi, ti) = perm[(perm[xi] + ti) & 255]
+  - Time is blended once per lattice column (ti, ti+1, eased), with each
+    column's time shifted by a hash fraction of a cell: columns cross their
+    time lattice at different moments, so the row never stalls as a whole
+    (a shared eased fraction stopped every cell at once, every 256 units).
+    x is blended per sample with an eased fraction.
+  - The row is walked incrementally: samples that stay in the same lattice
+    cell, or step into the next one, reuse the lattice columns already read.
+    That covers the strip rows (120..380 units per anchor) and part of the
+    fire fine row (450); the party (4000) and broad fire (1800) matrix rows
+    skip cells and read two columns per sample.
+
+ Units match inoise8: x and t are 8.8 fixed point, 256 = one lattice cell,
+ so scale/speed constants tuned for inoise8 give the same spatial scale and
+ speed; NOISE_BENCH compares the frame-to-frame motion with inoise8's.
+
+ Cost on AVR: a few pgm reads + two lerps per lattice column, one ease + one
+ lerp per sample (inoise8 is several hundred cycles per sample).
+*/
+
+namespace Noise1D {
+
+  // row[i] = noise(x0 + i * step, t) for i in 0..n-1 (x wraps at 16 bits).
+  void fillRow(uint8_t *row, uint8_t n, uint16_t x0, uint16_t step, uint16_t t);
+
+  // Single sample (no reuse); same value fillRow() produces at x.
+  uint8_t sample(uint16_t x, uint16_t t);
+}
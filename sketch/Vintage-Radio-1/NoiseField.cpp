@@ -0,0 +1,222 @@
+// NoiseField.cpp
+#include "NoiseField.h"
+#include "Noise1D.h"
+#include "PhaseClock.h"
+
+namespace NoiseField {
+
+  static uint8_t s_rowA[ROW_LEN];
+  static uint8_t s_rowB[ROW_LEN];
+
+  static Theme    s_theme = THEME_NONE;
+  static uint32_t s_lastFrameMs = 0;
+  static uint16_t s_noiseSamples = 0;
+  static bool     s_fineValid = false; // rowB computed for the current frame
+
+  // Time bases (advance on elapsed time, see PhaseClock::Motion)
+  static PhaseClock::Motion s_partyTime;
+  static PhaseClock::Motion s_sparkNoiseTime;
+  static PhaseClock::Motion s_sparkNoiseTime2;
+  static PhaseClock::Motion s_sparkDriftX;
+  static PhaseClock::Motion s_sparkDriftX2; // octave 2 drifts back at half speed
+  static PhaseClock::Motion s_emberTime;
+  static PhaseClock::Motion s_emberDriftX;
+  static uint16_t s_partyZ = 0;              // party time incl. swirl (strip rows)
+
+  static void computeParty(uint16_t dtMs) {
+    s_partyTime.advance(dtMs, PARTY_TIME_NOISE_SPEED);
+    const uint8_t swirlA = PhaseClock::beatsin8(7);
+    const uint8_t swirlB = PhaseClock::beatsin8(13);
+    const uint16_t z = (uint16_t)(s_partyTime.value() + (swirlA / 2) + (swirlB / 3));
+    s_partyZ = z;
+
+    Noise1D::fillRow(s_rowA, ROW_LEN, 0, PARTY_COLUMN_NOISE_SCALE, z);
+    s_noiseSamples = (uint16_t)(s_noiseSamples + ROW_LEN);
+  }
+
+  // Octave 2 drifts left at half the speed of octave 1.
+  static void computeFireFine() {
+    const uint16_t x2 = (uint16_t)(0 - s_sparkDriftX2.value());
+    Noise1D::fillRow(s_rowB, ROW_LEN, x2, FIRE_SPARK_NOISE_SCALE2, s_sparkNoiseTime2.value());
+    s_noiseSamples = (uint16_t)(s_noiseSamples + ROW_LEN);
+    s_fineValid = true;
+  }
+
+  static void computeFire(uint16_t dtMs, bool fine) {
+    // Both octaves keep moving, so the fine one resumes in step.
+    s_sparkNoiseTime.advance(dtMs, FIRE_SPARK_NOISE_SPEED);
+    s_sparkNoiseTime2.advance(dtMs, FIRE_SPARK_NOISE_SPEED2);
+    s_sparkDriftX.advance(dtMs, FIRE_SPARK_DRIFT_SPEED);
+    s_sparkDriftX2.advance(dtMs, FIRE_SPARK_DRIFT_SPEED, 1);
+    s_emberTime.advance(dtMs, EMBER_TIME_NOISE_SPEED);
+    s_emberDriftX.advance(dtMs, EMBER_DRIFT_SPEED);
+
+    Noise1D::fillRow(s_rowA, ROW_LEN, s_sparkDriftX.value(), FIRE_SPARK_NOISE_SCALE, s_sparkNoiseTime.value());
+    s_noiseSamples = (uint16_t)(s_noiseSamples + ROW_LEN);
+    if (fine) computeFireFine();
+  }
+
+  static inline uint8_t sampleRow(const uint8_t *row, uint16_t pos8_8) {
+    const uint8_t i0 = (uint8_t)((pos8_8 >> 8) % ROW_LEN);
+    const uint8_t i1 = (uint8_t)((i0 + 1) % ROW_LEN);
+    return lerp8by8(row[i0], row[i1], (uint8_t)(pos8_8 & 0xFF));
+  }
+
+  void prepare(Theme theme, bool fine) {
+    const uint32_t now = PhaseClock::nowMs();
+    if (theme == s_theme && (uint32_t)(now - s_lastFrameMs) < FIELD_FRAME_MS) {
+      if (fine && !s_fineValid && theme == THEME_FIRE) computeFireFine();
+      return;
+    }
+
+    s_theme = theme;
+    s_fineValid = false;
+    const uint16_t dt = PhaseClock::elapsed(s_lastFrameMs);
+
+    switch (theme) {
+      case THEME_PARTY: computeParty(dt); break;
+      case THEME_FIRE:  computeFire(dt, fine); break;
+      default: break;
+    }
+  }
+
+  const uint8_t *rowA() {
+    return s_rowA;
+  }
+
+  const uint8_t *rowB() {
+    return s_rowB;
+  }
+
+  // Each ember octave drifts at its own multiple and reads the time at its
+  // own offset, so the three rows are independent samples.
+  void stripRows(bool fine, uint8_t n, uint8_t *a, uint8_t *b, uint8_t *c) {
+    switch (s_theme) {
+      case THEME_PARTY:
+        Noise1D::fillRow(a, n, 0, PARTY_STRIP_NOISE_SCALE, s_partyZ);
+        s_noiseSamples = (uint16_t)(s_noiseSamples + n);
+        break;
+      case THEME_FIRE: {
+        const uint16_t t = s_emberTime.value();
+        const uint16_t drift = s_emberDriftX.value();
+        Noise1D::fillRow(a, n, drift, EMBER_SCALE_COARSE, t);
+        if (fine) Noise1D::fillRow(b, n, (uint16_t)(drift * 3), EMBER_SCALE_FINE, (uint16_t)(t + 53));
+        Noise1D::fillRow(c, n, (uint16_t)(drift * 5), EMBER_SCALE_BRIGHT, (uint16_t)(t + 97));
+        s_noiseSamples = (uint16_t)(s_noiseSamples + (fine ? 3 : 2) * n);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  uint8_t sampleA(uint16_t pos8_8) {
+    return sampleRow(s_rowA, pos8_8);
+  }
+
+  uint8_t sampleB(uint16_t pos8_8) {
+    return sampleRow(s_rowB, pos8_8);
+  }
+
+  uint16_t noiseSamples() {
+    return s_noiseSamples;
+  }
+
+#if (DEBUG == 1) && (NOISE_BENCH == 1)
+  // Motion of a party matrix row over FRAMES frames at the party speed:
+  // mean summed |change| per frame, and the lowest 8-frame average of it
+  // (near 0 = the whole row stalls). inoise8 vs Noise1D should match in
+  // mean and neither should stall.
+  static void reportMotion(bool useInoise) {
+    static const uint16_t FRAMES = 256;
+    uint8_t prev[ROW_LEN];
+    uint8_t row[ROW_LEN];
+    uint16_t window[8] = {0};
+    uint32_t sum = 0;
+    uint32_t windowSum = 0;
+    uint32_t windowMin = 0xFFFFFFFFUL;
+    for (uint16_t f = 0; f <= FRAMES; ++f) {
+      const uint16_t t = (uint16_t)(f * PARTY_TIME_NOISE_SPEED);
+      if (useInoise) {
+        for (uint8_t i = 0; i < ROW_LEN; ++i) row[i] = inoise8((uint16_t)(i * PARTY_COLUMN_NOISE_SCALE), t);
+      } else {
+        Noise1D::fillRow(row, ROW_LEN, 0, PARTY_COLUMN_NOISE_SCALE, t);
+      }
+      if (f > 0) {
+        uint16_t d = 0;
+        for (uint8_t i = 0; i < ROW_LEN; ++i) d = (uint16_t)(d + abs((int16_t)row[i] - prev[i]));
+        sum += d;
+        windowSum = windowSum + d - window[f & 7];
+        window[f & 7] = d;
+        if (f >= 8 && windowSum < windowMin) windowMin = windowSum;
+      }
+      memcpy(prev, row, ROW_LEN);
+    }
+    debug(useInoise ? F("[NOISE] party motion inoise8 mean/min8: ")
+                    : F("[NOISE] party motion Noise1D mean/min8: "));
+    debug(sum / FRAMES); debug(F(" / ")); debugln(windowMin / 8);
+  }
+
+  // Time the fire rows (2 x ROW_LEN samples) and the old per-anchor ember
+  // lookups (3 x 24) with inoise8 vs Noise1D. Results in us per pass.
+  void benchmark() {
+    static const uint8_t PASSES = 16;
+    static const uint8_t EMBER_ANCHORS = 24;
+    uint8_t row[ROW_LEN];
+    volatile uint8_t sink = 0;
+
+    uint32_t t0 = micros();
+    for (uint8_t p = 0; p < PASSES; ++p) {
+      for (uint8_t i = 0; i < ROW_LEN; ++i) {
+        sink ^= inoise8((uint16_t)(i * FIRE_SPARK_NOISE_SCALE), (uint16_t)(p * FIRE_SPARK_NOISE_SPEED));
+        sink ^= inoise8((uint16_t)(i * FIRE_SPARK_NOISE_SCALE2), (uint16_t)(p * FIRE_SPARK_NOISE_SPEED2));
+      }
+    }
+    const uint32_t fireInoise = (micros() - t0) / PASSES;
+
+    t0 = micros();
+    for (uint8_t p = 0; p < PASSES; ++p) {
+      Noise1D::fillRow(row, ROW_LEN, 0, FIRE_SPARK_NOISE_SCALE, (uint16_t)(p * FIRE_SPARK_NOISE_SPEED));
+      sink ^= row[p & (ROW_LEN - 1)];
+      Noise1D::fillRow(row, ROW_LEN, 0, FIRE_SPARK_NOISE_SCALE2, (uint16_t)(p * FIRE_SPARK_NOISE_SPEED2));
+      sink ^= row[p & (ROW_LEN - 1)];
+    }
+    const uint32_t fireNoise1D = (micros() - t0) / PASSES;
+
+    t0 = micros();
+    for (uint8_t p = 0; p < PASSES; ++p) {
+      for (uint8_t v = 0; v < EMBER_ANCHORS; ++v) {
+        sink ^= inoise8((uint16_t)(v * 360), p);
+        sink ^= inoise8((uint16_t)(v * 120), (uint16_t)(p + 53));
+        sink ^= inoise8((uint16_t)(v * 220), (uint16_t)(p + 97));
+      }
+    }
+    const uint32_t emberInoise = (micros() - t0) / PASSES;
+
+    t0 = micros();
+    for (uint8_t p = 0; p < PASSES; ++p) {
+      Noise1D::fillRow(row, EMBER_ANCHORS, 0, 360, p);
+      sink ^= row[0];
+      Noise1D::fillRow(row, EMBER_ANCHORS, 0, 120, (uint16_t)(p + 53));
+      sink ^= row[0];
+      Noise1D::fillRow(row, EMBER_ANCHORS, 0, 220, (uint16_t)(p + 97));
+      sink ^= row[0];
+    }
+    const uint32_t emberNoise1D = (micros() - t0) / PASSES;
+    (void)sink;
+
+    debug(F("[NOISE] fire rows us inoise8/Noise1D: "));
+    debug(fireInoise); debug(F(" / ")); debugln(fireNoise1D);
+    debug(F("[NOISE] ember anchors us inoise8/Noise1D: "));
+    debug(emberInoise); debug(F(" / ")); debugln(emberNoise1D);
+
+    reportMotion(true);
+    reportMotion(false);
+  }
+
+  void invalidate() {
+    s_theme = THEME_NONE;
+  }
+#endif
+
+} // namespace NoiseField
@@ -0,0 +1,98 @@
+// NoiseField.h
+#pragma once
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+
+/*
+ ============================================================
+ Shared per-frame noise field (matrix + strip)
+ ============================================================
+ The matrix and the strip show the same theme, so their noise comes from
+ one place: a field of ROW_LEN samples (one per matrix column, filled with
+ Noise1D rows) computed at most once per FIELD_FRAME_MS and sampled by both
+ surfaces. The matrix reads
+ a row cell per column.
+
+ The strip samples the same time bases at its own spatial scale (one
+ cell per strip anchor, a few hundred noise units apart instead of the
+ matrix's 1800..4000), so its marble stays smooth over 90 LEDs:
+ stripRows() fills caller buffers on demand. Embers keep their own slow
+ clock and three decorrelated octaves (colour coarse / fine, brightness).
+
+ Themes:
+  - THEME_PARTY: rowA = marble noise (swirl phases folded into z)
+  - THEME_FIRE:  rowA = broad octave, rowB = fine octave
+
+ Detail: prepare(theme, false) skips the fine octave (rowB is then stale)
+ for renderers running at FrameScheduler::QUALITY_LOW. A later
+ prepare(theme, true) in the same frame fills it in.
+
+ Only one theme is live at a time (both surfaces follow the same folder),
+ so the rows are shared between themes. Switching theme recomputes at once.
+
+ SRAM: 2 x ROW_LEN bytes + a few counters.
+*/
+
+namespace NoiseField {
+
+  static const uint8_t  ROW_LEN        = 32;  // one cell per matrix column
+  static const uint16_t FIELD_FRAME_MS = 30;  // recompute at most this often
+
+  // Party marble (relaxed)
+  static const uint16_t PARTY_COLUMN_NOISE_SCALE = 4000;
+  static const uint16_t PARTY_TIME_NOISE_SPEED   = 3;
+
+  // Fire sparks / embers
+  static const uint16_t FIRE_SPARK_NOISE_SCALE   = 1800;
+  static const uint16_t FIRE_SPARK_NOISE_SPEED   = 9;
+  static const uint16_t FIRE_SPARK_NOISE_SCALE2  = 450;
+  static const uint16_t FIRE_SPARK_NOISE_SPEED2  = 17;
+  static const uint16_t FIRE_SPARK_DRIFT_SPEED   = 3;
+
+  // Strip (per anchor)
+  static const uint16_t PARTY_STRIP_NOISE_SCALE  = 380;
+  static const uint16_t EMBER_SCALE_COARSE       = 360;
+  static const uint16_t EMBER_SCALE_FINE         = 120;
+  static const uint16_t EMBER_SCALE_BRIGHT       = 220;
+  static const uint16_t EMBER_TIME_NOISE_SPEED   = 1;
+  static const uint16_t EMBER_DRIFT_SPEED        = 1;
+
+  enum Theme : uint8_t {
+    THEME_NONE = 0,
+    THEME_PARTY,
+    THEME_FIRE
+  };
+
+  // Make the field current for theme (no-op if already computed this frame).
+  // fine = false leaves rowB stale (fire: fine octave not needed).
+  void prepare(Theme theme, bool fine = true);
+
+  // Rows of the last prepared theme (ROW_LEN cells each).
+  const uint8_t *rowA();
+  const uint8_t *rowB();
+
+  // Strip rows of n anchors for the last prepared theme (call prepare()
+  // first; uses its time, does not advance it).
+  //   THEME_PARTY: a = marble (b, c unused)
+  //   THEME_FIRE:  a = ember colour coarse, b = colour fine (skipped when
+  //                fine = false), c = brightness
+  void stripRows(bool fine, uint8_t n, uint8_t *a, uint8_t *b, uint8_t *c);
+
+  // Sample a row at pos (8.8 fixed point, in cells), linearly interpolated
+  // between neighbouring cells and wrapping at ROW_LEN.
+  uint8_t sampleA(uint16_t pos8_8);
+  uint8_t sampleB(uint16_t pos8_8);
+
+  // Diagnostics: noise samples computed by the field so far.
+  uint16_t noiseSamples();
+
+#if (DEBUG == 1) && (NOISE_BENCH == 1)
+  // Print inoise8 vs Noise1D timings for the fire / ember workloads.
+  void benchmark();
+
+  // Make the next prepare() recompute the field (renderer benchmarks time
+  // the frame that pays for it).
+  void invalidate();
+#endif
+}
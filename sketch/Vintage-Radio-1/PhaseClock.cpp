@@ -0,0 +1,43 @@
+// PhaseClock.cpp
+#include "PhaseClock.h"
+
+namespace PhaseClock {
+
+  static uint32_t s_nowMs = 0;
+  static uint32_t s_t280 = 0; // s_nowMs * 280 (wraps like FastLED's beat88 product)
+
+  void tick(uint32_t nowMs) {
+    s_nowMs = nowMs;
+    s_t280 = nowMs * 280UL;
+  }
+
+  uint32_t nowMs() {
+    return s_nowMs;
+  }
+
+  uint16_t beat16(uint8_t bpm) {
+    // == (ms * (bpm << 8) * 280) >> 16 in 32-bit wrapping arithmetic
+    return (uint16_t)((s_t280 * bpm) >> 8);
+  }
+
+  uint8_t beat8(uint8_t bpm) {
+    return (uint8_t)(beat16(bpm) >> 8);
+  }
+
+  uint8_t beatsin8(uint8_t bpm, uint8_t lowest, uint8_t highest, uint8_t phaseOffset) {
+    const uint8_t s = sin8((uint8_t)(beat8(bpm) + phaseOffset));
+    return (uint8_t)(lowest + scale8(s, (uint8_t)(highest - lowest)));
+  }
+
+  uint16_t beatsin16(uint8_t bpm, uint16_t lowest, uint16_t highest, uint16_t phaseOffset) {
+    const uint16_t s = (uint16_t)(sin16((uint16_t)(beat16(bpm) + phaseOffset)) + 32768);
+    return (uint16_t)(lowest + scale16(s, (uint16_t)(highest - lowest)));
+  }
+
+  uint16_t elapsed(uint32_t &lastMs) {
+    const uint32_t dt = s_nowMs - lastMs;
+    lastMs = s_nowMs;
+    return (dt > MAX_DT_MS) ? MAX_DT_MS : (uint16_t)dt;
+  }
+
+} // namespace PhaseClock
@@ -0,0 +1,76 @@
+// PhaseClock.h
+#pragma once
+#include <Arduino.h>
+#include <FastLED.h>
+
+/*
+ ============================================================
+ Global phase clock (beat-synced effects)
+ ============================================================
+ One time sample per loop() for every BPM-driven effect: the dial breath,
+ the shared folder 4 breath, the xmas pulses and the spooky fallback
+ breath on matrix and strip, and the party swirl.
+
+ Because all outputs read the same sample, they stay phase-locked even
+ when they render at different moments of the loop (or at different
+ frame rates), and millis() is read once instead of per call.
+
+ Phases use FastLED's formula (beat88: ms * bpm88 * 280 >> 16), so values
+ match beat16()/beatsin8()/beatsin16() evaluated at the same millisecond.
+ ms * 280 is computed once per tick; each phase is then one multiply.
+
+ Usage:
+   PhaseClock::tick(now);                 // top of loop()
+   uint8_t v = PhaseClock::beatsin8(18, 30, 255, 128);
+
+ Elapsed-time animation:
+  - Renderer speeds stay tuned as "units per nominal 30 ms frame" but are
+    applied per elapsed millisecond (Motion), so skipped frames or a
+    different frame rate do not change the animation speed.
+  - elapsed() returns the ms since a renderer's previous frame, capped at
+    MAX_DT_MS so a long hold/off resumes without a jump.
+*/
+
+namespace PhaseClock {
+
+  // Sample the clock (call once per loop(), before any effect reads it).
+  void tick(uint32_t nowMs);
+
+  // The sampled time.
+  uint32_t nowMs();
+
+  // Sawtooth phase 0..65535 / 0..255 at bpm (whole beats per minute).
+  uint16_t beat16(uint8_t bpm);
+  uint8_t beat8(uint8_t bpm);
+
+  // Sine between lowest..highest at bpm; phaseOffset shifts the wave.
+  uint8_t beatsin8(uint8_t bpm, uint8_t lowest = 0, uint8_t highest = 255, uint8_t phaseOffset = 0);
+  uint16_t beatsin16(uint8_t bpm, uint16_t lowest = 0, uint16_t highest = 65535, uint16_t phaseOffset = 0);
+
+  // ---- Elapsed-time (dt) animation ----
+  static const uint16_t NOMINAL_FRAME_MS = 30;  // speed constants are per this frame
+  static const uint16_t MAX_DT_MS        = 250;
+
+  // ms from lastMs to the sampled time (capped); sets lastMs to the sampled time.
+  uint16_t elapsed(uint32_t &lastMs);
+
+  // dt as a fraction of a nominal frame (Q8: 256 = one 30 ms frame).
+  inline uint16_t framesQ8(uint16_t dtMs) {
+    return (uint16_t)(((uint32_t)dtMs << 8) / NOMINAL_FRAME_MS);
+  }
+
+  // A position advancing at a per-frame speed, in 16.16 fixed point.
+  // value() wraps at 16 bits (noise time/offset units).
+  struct Motion {
+    uint32_t q16;
+
+    Motion() : q16(0) {}
+
+    // perFrame units per nominal frame, optionally halved `shift` times.
+    inline void advance(uint16_t dtMs, uint16_t perFrame, uint8_t shift = 0) {
+      q16 += (uint32_t)dtMs * ((((uint32_t)perFrame << 16) >> shift) / NOMINAL_FRAME_MS);
+    }
+
+    inline uint16_t value() const { return (uint16_t)(q16 >> 16); }
+  };
+}
@@ -0,0 +1,96 @@
+// Playback.cpp
+#include "Playback.h"
+#include "PhaseClock.h"
+
+namespace Playback {
+
+  // Capture sink state (bake() is not re-entrant).
+  static CRGB     s_capColours[MAX_RUNS];
+  static uint8_t  s_capLengths[MAX_RUNS];
+  static uint8_t  s_capCount = 0;
+  static bool     s_capOverflow = false;
+
+  static void captureRun(uint16_t first, uint16_t length, const CRGB &colour) {
+    (void)first;
+    if (s_capCount >= MAX_RUNS || length > 255) {
+      s_capOverflow = true;
+      return;
+    }
+    s_capColours[s_capCount] = colour;
+    s_capLengths[s_capCount] = (uint8_t)length;
+    s_capCount++;
+  }
+
+  // ms at which beat16(bpm) reaches phase (FastLED beat88 formula, rounded up).
+  static uint32_t timeOfPhase(uint16_t phase, uint8_t bpm) {
+    const uint32_t perMs = 280UL * bpm;
+    return (((uint32_t)phase << 8) + perMs - 1) / perMs;
+  }
+
+  bool bake(Clip &clip, const uint8_t *program, uint16_t count, uint8_t bpm,
+            void *storage, uint16_t storageBytes) {
+    if (program == nullptr || bpm == 0) return false;
+
+    const EffectVM::Sink capture = { count, nullptr, captureRun };
+    const uint32_t savedNow = PhaseClock::nowMs();
+    CRGB *keys = (CRGB *)storage;
+    bool ok = true;
+
+    // Keyframe 0 fixes the run layout and the keyframe count.
+    uint8_t shift = 0;
+    for (uint8_t k = 0; ok; ++k) {
+      if (k == 0) {
+        PhaseClock::tick(timeOfPhase(0, bpm));
+      } else {
+        if (k >= (uint8_t)(1 << shift)) break;
+        PhaseClock::tick(timeOfPhase((uint16_t)((uint32_t)k << (16 - shift)), bpm));
+      }
+      s_capCount = 0;
+      s_capOverflow = false;
+      EffectVM::run(program, capture);
+      if (s_capOverflow || s_capCount == 0) { ok = false; break; }
+
+      if (k == 0) {
+        clip.runCount = s_capCount;
+        for (uint8_t r = 0; r < s_capCount; ++r) clip.lengths[r] = s_capLengths[r];
+        const uint16_t perKey = (uint16_t)(s_capCount * sizeof(CRGB));
+        while (shift < 4 && (uint16_t)(perKey << (shift + 1)) <= storageBytes) shift++;
+        if (shift == 0) { ok = false; break; }
+      } else {
+        if (s_capCount != clip.runCount) { ok = false; break; }
+        for (uint8_t r = 0; r < s_capCount; ++r) {
+          if (s_capLengths[r] != clip.lengths[r]) ok = false;
+        }
+        if (!ok) break;
+      }
+      for (uint8_t r = 0; r < s_capCount; ++r) keys[(uint16_t)k * clip.runCount + r] = s_capColours[r];
+    }
+
+    PhaseClock::tick(savedNow);
+    if (!ok) return false;
+
+    clip.keys = keys;
+    clip.bpm = bpm;
+    clip.keyShift = shift;
+    return true;
+  }
+
+  void play(const Clip &clip, const EffectVM::Sink &sink) {
+    const uint16_t phase = PhaseClock::beat16(clip.bpm);
+    const uint8_t mask = (uint8_t)((1 << clip.keyShift) - 1);
+    const uint8_t k0 = (uint8_t)(phase >> (16 - clip.keyShift));
+    const uint8_t k1 = (uint8_t)((k0 + 1) & mask);
+    const uint8_t frac = (uint8_t)(phase >> (8 - clip.keyShift));
+
+    const CRGB *a = &clip.keys[(uint16_t)k0 * clip.runCount];
+    const CRGB *b = &clip.keys[(uint16_t)k1 * clip.runCount];
+    uint16_t first = 0;
+    for (uint8_t r = 0; r < clip.runCount; ++r) {
+      const uint16_t length = (first + clip.lengths[r] <= sink.count)
+                              ? clip.lengths[r] : (uint16_t)(sink.count - first);
+      sink.run(first, length, blend(a[r], b[r], frac));
+      first = (uint16_t)(first + length);
+    }
+  }
+
+} // namespace Playback
@@ -0,0 +1,50 @@
+// Playback.h
+#pragma once
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "EffectVM.h"
+
+/*
+ ============================================================
+ Baked playback for periodic themes
+ ============================================================
+ A theme whose frames depend only on one BPM phase (christmas pulse)
+ computes the same period forever. Instead of running its EffectVM program
+ every frame, the surface bakes one period into keyframes at theme entry
+ and plays them back:
+
+  - bake(): run the program at KEYFRAMES phases of one period (the clock
+    is moved to each phase and restored) and store each frame's runs.
+    Run lengths must be the same in every keyframe; only colours vary.
+  - play(): pick the two keyframes around PhaseClock::beat16(bpm), blend
+    the run colours by the phase fraction and emit the runs to the sink.
+
+ Per frame that is one phase read and a blend per run. Keyframes live in
+ caller storage (a surface's idle theme arena); the count is the largest
+ power of two up to MAX_KEYFRAMES that fits. The program must be periodic
+ at bpm (BEAT / BEATSIN at bpm or its multiples, no noise).
+*/
+
+namespace Playback {
+
+  static const uint8_t MAX_RUNS      = 4;
+  static const uint8_t MAX_KEYFRAMES = 16;
+
+  struct Clip {
+    CRGB    *keys;               // [keyframes][runCount] in caller storage
+    uint8_t  bpm;
+    uint8_t  keyShift;           // log2(keyframes)
+    uint8_t  runCount;
+    uint8_t  lengths[MAX_RUNS];  // elements per run (same in every keyframe)
+  };
+
+  // Bake one period of program for a surface of count elements into
+  // storage. False if it does not fit (too many runs, run lengths that
+  // change over the period, no room for 2 keyframes): play it live then.
+  bool bake(Clip &clip, const uint8_t *program, uint16_t count, uint8_t bpm,
+            void *storage, uint16_t storageBytes);
+
+  // Emit the interpolated frame for the current phase.
+  void play(const Clip &clip, const EffectVM::Sink &sink);
+}
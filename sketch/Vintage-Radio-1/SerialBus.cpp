@@ -0,0 +1,116 @@
+// SerialBus.cpp
+#include "SerialBus.h"
+#include "Config.h"
+
+namespace SerialBus {
+
+  static SoftwareSerial *s_ports[LINK_COUNT] = { nullptr, nullptr, nullptr };
+
+  // Current listener (LINK_NONE if nothing is listening)
+  static Link s_listener = LINK_NONE;
+
+  // Active receive window
+  static Link     s_windowOwner = LINK_NONE;
+  static uint32_t s_windowStartMs = 0;
+  static uint16_t s_windowMs = 0;
+
+  // Diagnostics
+  static uint16_t s_lostBytes = 0;
+  static uint16_t s_overflows = 0;
+
+  static inline bool validLink(Link link) {
+    return (link > LINK_NONE) && (link < LINK_COUNT) && (s_ports[link] != nullptr);
+  }
+
+  static inline bool windowActive() {
+    if (s_windowOwner == LINK_NONE) return false;
+    if ((uint32_t)(millis() - s_windowStartMs) >= s_windowMs) {
+      s_windowOwner = LINK_NONE;
+      return false;
+    }
+    return true;
+  }
+
+  // Account for whatever the outgoing listener still had buffered;
+  // SoftwareSerial::listen() resets the shared RX buffer.
+  static void accountOutgoing() {
+    if (s_listener == LINK_NONE) return;
+    SoftwareSerial *prev = s_ports[s_listener];
+    const int pending = prev->available();
+    if (pending > 0) s_lostBytes = (uint16_t)(s_lostBytes + pending);
+    if (prev->overflow()) s_overflows++;
+    if (pending > 0) DBG_BUS2(F("[BUS] Lost on switch: "), pending);
+  }
+
+  static void switchTo(Link link) {
+    if (s_listener == link) return;
+    accountOutgoing();
+    s_ports[link]->listen();
+    s_listener = link;
+  }
+
+  static void openWindow(Link link, uint16_t windowMs) {
+    if (windowMs == 0) return;
+    s_windowOwner = link;
+    s_windowStartMs = millis();
+    s_windowMs = windowMs;
+  }
+
+  void attach(Link link, SoftwareSerial &port) {
+    if (link <= LINK_NONE || link >= LINK_COUNT) return;
+    s_ports[link] = &port;
+  }
+
+  void begin(Link link, long baud) {
+    if (!validLink(link)) return;
+    if (s_listener != link) accountOutgoing();
+    s_ports[link]->begin(baud); // also makes it the listener
+    s_listener = link;
+  }
+
+  void end(Link link) {
+    if (!validLink(link)) return;
+    s_ports[link]->end();
+    if (s_listener == link) s_listener = LINK_NONE;
+    if (s_windowOwner == link) s_windowOwner = LINK_NONE;
+  }
+
+  bool request(Link link, uint16_t windowMs) {
+    if (!validLink(link)) return false;
+    if (windowActive() && s_windowOwner != link) return false;
+    switchTo(link);
+    openWindow(link, windowMs);
+    return true;
+  }
+
+  void claim(Link link, uint16_t windowMs) {
+    if (!validLink(link)) return;
+    // Foreign windows are bounded (a reply timeout), so this wait is too.
+    while (windowActive() && s_windowOwner != link) {
+      delay(1);
+    }
+    switchTo(link);
+    openWindow(link, windowMs);
+  }
+
+  void release(Link link) {
+    if (s_windowOwner == link) s_windowOwner = LINK_NONE;
+  }
+
+  bool isListening(Link link) {
+    return (link != LINK_NONE) && (s_listener == link);
+  }
+
+  bool inWindow(Link link) {
+    return windowActive() && (s_windowOwner == link);
+  }
+
+  uint16_t lostBytes() {
+    return s_lostBytes;
+  }
+
+  uint16_t overflowCount() {
+    return s_overflows;
+  }
+
+} // namespace SerialBus
@@ -0,0 +1,66 @@
+// SerialBus.h
+#pragma once
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+
+/*
+ ============================================================
+ SoftwareSerial Bus Arbiter (MP3 + Bluetooth links)
+ ============================================================
+ Only one SoftwareSerial instance can receive at a time, and switching the
+ listener silently discards whatever the previous listener had buffered.
+ This module is the single owner of "who is listening".
+
+ Rules:
+  - Modules never call listen()/begin()/end() on their SoftwareSerial directly;
+    they go through SerialBus::begin()/end()/request()/claim().
+  - A receive window (windowMs) pins the listener to one link so a command can
+    wait for its reply. Other links cannot take the listener until the window
+    expires or the owner calls release().
+  - request() is non-blocking (returns false if another link holds a window).
+  - claim() waits for a foreign window to expire (windows are short and
+    bounded), then grants. Use it on TX paths that must not drop a command.
+
+ Diagnostics:
+  - lostBytes(): RX bytes discarded because the listener was switched away
+    while they were still unread.
+  - overflowCount(): RX buffer overflows observed at switch time.
+*/
+
+namespace SerialBus {
+
+  enum Link : uint8_t {
+    LINK_NONE = 0,
+    LINK_MP3,
+    LINK_BT,
+    LINK_COUNT
+  };
+
+  // Register a port for a link (call once, before begin()).
+  void attach(Link link, SoftwareSerial &port);
+
+  // Start the port; it becomes the listener (SoftwareSerial::begin() listens).
+  void begin(Link link, long baud);
+
+  // Stop the port; if it was listening, nothing listens afterwards.
+  void end(Link link);
+
+  // Make link the listener and hold it for windowMs (0 = no hold).
+  // Non-blocking: returns false if another link holds an active window.
+  bool request(Link link, uint16_t windowMs);
+
+  // As request(), but waits out any foreign window first. Always grants.
+  void claim(Link link, uint16_t windowMs);
+
+  // End link's receive window early (e.g. reply received).
+  void release(Link link);
+
+  // True if link is the current listener.
+  bool isListening(Link link);
+
+  // True while link holds an unexpired receive window.
+  bool inWindow(Link link);
+
+  uint16_t lostBytes();
+  uint16_t overflowCount();
+}
@@ -0,0 +1,175 @@
+// Themes.cpp
+#include "Themes.h"
+#include "EffectVM.h"
+#include "LedMatrix.h"
+#include "LedStrip.h"
+#include "NoiseField.h"
+#include "PhaseClock.h"
+#include "Playback.h"
+
+namespace Themes {
+
+  using namespace EffectVM;
+
+  // ---- EffectVM programs (see EffectVM.h for the opcodes) ----
+
+  // Party marble, one palette colour per column from the shared noise row
+  // (INDEX * ROW_LEN lands exactly on cell col, as LedMatrix::renderParty()).
+  static const uint8_t PARTY_MATRIX[] PROGMEM = {
+    OP_FIELD, NoiseField::THEME_PARTY,
+    OP_FILL, 0,
+      OP_INDEX, OP_NOISE, OP_PUSH, 30, OP_ADD, OP_PAL, PAL_PARTY,
+    OP_NEXT,
+    OP_END
+  };
+
+  // Christmas: left half red (phase 0), right half green (phase 128).
+  static const uint8_t XMAS_MATRIX[] PROGMEM = {
+    OP_RGB, 255, 0, 0,
+    OP_BEATSIN, LedMatrix::XMAS_PULSE_BPM, LedMatrix::XMAS_MIN_BRIGHT, LedMatrix::XMAS_MAX_BRIGHT, 0,
+    OP_DIM, OP_SPAN, 128,
+    OP_RGB, 0, 255, 0,
+    OP_BEATSIN, LedMatrix::XMAS_PULSE_BPM, LedMatrix::XMAS_MIN_BRIGHT, LedMatrix::XMAS_MAX_BRIGHT, 128,
+    OP_DIM, OP_SPAN, 0,
+    OP_END
+  };
+
+  // Strip: mirrored colours, same phases as the matrix halves. 134/256 of
+  // 90 LEDs = 47 (half + 2, as LedStrip::renderXmasHalfPulse()).
+  static const uint8_t XMAS_STRIP[] PROGMEM = {
+    OP_RGB, 0, 255, 0,
+    OP_BEATSIN, LedMatrix::XMAS_PULSE_BPM, LedMatrix::XMAS_MIN_BRIGHT, LedMatrix::XMAS_MAX_BRIGHT, 128,
+    OP_DIM, OP_SPAN, 134,
+    OP_RGB, 255, 0, 0,
+    OP_BEATSIN, LedMatrix::XMAS_PULSE_BPM, LedMatrix::XMAS_MIN_BRIGHT, LedMatrix::XMAS_MAX_BRIGHT, 0,
+    OP_DIM, OP_SPAN, 0,
+    OP_END
+  };
+
+  // Frame rates (FrameScheduler::Rate: target ms, slowest ms, render budget us).
+  // Fire's heat simulation steps every PhaseClock::NOMINAL_FRAME_MS, so a
+  // faster matrix rate would only repeat frames. Xmas and spooky are slow
+  // breaths: a lower rate only coarsens their steps slightly. Fire and embers
+  // have a render budget (QUALITY_LOW drops the fine noise octave). A budget
+  // is the full-quality cost from NOISE_BENCH ("fire matrix" / "ember strip
+  // us full/low", field included) plus ~25%; the low cost has to stay under
+  // 3/4 of it, or the surface never returns to QUALITY_FULL.
+  static const Theme TABLE[] PROGMEM = {
+    // BETWEEN_STATIONS (folder 99): LEDs dark, dial flickers
+    { nullptr, nullptr, nullptr, nullptr,
+      { 30, 30, 0 }, { 30, 30, 0 },
+      nullptr, 0, 0, DIAL_FLICKER, 0 },
+
+    // Folder 1: party marble
+    { LedMatrix::renderProgram, LedStrip::renderPartyMarble, PARTY_MATRIX, nullptr,
+      { 30, 60, 0 }, { 30, 60, 0 },
+      &PartyColors_p, 0, sizeof(LedStrip::MarbleState), DIAL_SOLID, 0 },
+
+    // Folder 2: fire columns / ember bed
+    { LedMatrix::renderFire, LedStrip::renderEmberMarble, nullptr, nullptr,
+      { 30, 40, 2500 }, { 30, 60, 2000 },
+      &HeatColors_p, sizeof(LedMatrix::FireState), sizeof(LedStrip::MarbleState), DIAL_SOLID, 0 },
+
+    // Folder 3: christmas half pulse (3.3 s)
+    { LedMatrix::renderProgram, LedStrip::renderProgram, XMAS_MATRIX, XMAS_STRIP,
+      { 50, 80, 0 }, { 50, 80, 0 },
+      nullptr, 0, 0, DIAL_SOLID, LedMatrix::XMAS_PULSE_BPM },
+
+    // Folder 4: spooky fog breath (6.7 s)
+    { LedMatrix::renderSpooky, LedStrip::renderSpookyFog, nullptr, nullptr,
+      { 80, 120, 0 }, { 80, 120, 0 },
+      nullptr, sizeof(LedMatrix::SpookyState), 0, DIAL_BREATH, 0 },
+  };
+
+  static const uint8_t COUNT = (uint8_t)(sizeof(TABLE) / sizeof(TABLE[0]));
+
+  static Theme   s_current;
+  static uint8_t s_currentId = 0xFF;
+
+  // Transition (see select())
+  static uint8_t  s_blend = 255;
+  static uint32_t s_blendLastMs = 0;
+
+  static void load(uint8_t id) {
+    memcpy_P(&s_current, &TABLE[id], sizeof(Theme));
+    s_currentId = id;
+  }
+
+  // Weight change for dtMs of a THEME_FADE_MS crossfade (255 = whole range).
+  static uint8_t blendStep(uint16_t dtMs) {
+    if (Config::THEME_FADE_MS == 0) return 255;
+    const uint32_t step = ((uint32_t)dtMs * 255UL + Config::THEME_FADE_MS - 1) / Config::THEME_FADE_MS;
+    return (step > 255) ? 255 : (uint8_t)step;
+  }
+
+  void select(uint8_t folder) {
+    const uint8_t id = (folder >= 1 && folder < COUNT) ? folder : BETWEEN_STATIONS;
+    const uint8_t step = blendStep(PhaseClock::elapsed(s_blendLastMs));
+
+    if (s_currentId == 0xFF) {          // boot: start on the theme
+      load(id);
+      s_blend = 255;
+      return;
+    }
+
+    // A change starts a crossfade from whatever the surfaces show now (they
+    // snapshot it on theme entry), also if the previous one is unfinished.
+    if (id != s_currentId) {
+      load(id);
+      s_blend = 0;
+    } else if (s_blend != 255) {
+      s_blend = (uint8_t)((255 - s_blend <= step) ? 255 : s_blend + step);
+    }
+  }
+
+  uint8_t blend() {
+    return s_blend;
+  }
+
+#if (DEBUG == 1) && (VM_BENCH == 1)
+  // Average us per frame over PASSES frames of r.
+  static uint32_t timeRenderer(Renderer r) {
+    static const uint8_t PASSES = 16;
+    const uint32_t t0 = micros();
+    for (uint8_t p = 0; p < PASSES; ++p) r();
+    return (micros() - t0) / PASSES;
+  }
+
+  static void runPartyMatrix() { LedMatrix::runProgram(PARTY_MATRIX); }
+  static void runXmasMatrix()  { LedMatrix::runProgram(XMAS_MATRIX); }
+  static void runXmasStrip()   { LedStrip::runProgram(XMAS_STRIP); }
+
+  // Baked playback of the xmas matrix program into the column buffer.
+  static void benchColumns(uint16_t first, uint16_t length, const CRGB &colour) {
+    fill_solid(&LedMatrix::columns[first], length, colour);
+  }
+  static const EffectVM::Sink s_benchSink = { LedMatrix::MATRIX_WIDTH, nullptr, benchColumns };
+  static Playback::Clip s_benchClip;
+  static void playXmasMatrix() { Playback::play(s_benchClip, s_benchSink); }
+
+  static void report(const __FlashStringHelper *name, Renderer native, Renderer vm) {
+    const uint32_t nativeUs = timeRenderer(native);
+    const uint32_t vmUs = timeRenderer(vm);
+    debug(name); debug(nativeUs); debug(F(" / ")); debugln(vmUs);
+  }
+
+  void benchmark() {
+    report(F("[VM] party matrix us native/VM: "), LedMatrix::renderParty, runPartyMatrix);
+    report(F("[VM] xmas matrix us native/VM: "),  LedMatrix::renderXmas, runXmasMatrix);
+    report(F("[VM] xmas strip us native/VM: "),   LedStrip::renderXmasHalfPulse, runXmasStrip);
+
+    uint8_t keys[Playback::MAX_KEYFRAMES * 2 * sizeof(CRGB)];
+    const uint32_t t0 = micros();
+    if (Playback::bake(s_benchClip, XMAS_MATRIX, LedMatrix::MATRIX_WIDTH,
+                       LedMatrix::XMAS_PULSE_BPM, keys, sizeof(keys))) {
+      const uint32_t bakeUs = micros() - t0;
+      report(F("[VM] xmas matrix us VM/baked: "), runXmasMatrix, playXmasMatrix);
+      debug(F("[VM] xmas matrix bake us: ")); debugln(bakeUs);
+    }
+    debug(F("[VM] program bytes party/xmas: "));
+    debug((uint16_t)sizeof(PARTY_MATRIX)); debug(F(" / "));
+    debugln((uint16_t)(sizeof(XMAS_MATRIX) + sizeof(XMAS_STRIP)));
+  }
+#endif
+
+} // namespace Themes
@@ -0,0 +1,89 @@
+// Themes.h
+#pragma once
+#include <Arduino.h>
+#include <FastLED.h>
+#include "Config.h"
+#include "FrameScheduler.h"
+
+/*
+ ============================================================
+ Theme registry (flash-resident)
+ ============================================================
+ One descriptor per theme in a PROGMEM table: matrix renderer, strip
+ renderer, frame rates, strip palette, per-surface state size and dial
+ behaviour. The main sketch selects the theme for the current folder once
+ per loop; LedMatrix, LedStrip and the dial logic all read the same
+ descriptor, so there is one dispatch path instead of a switch per module.
+
+  - Adding a theme costs a table row in flash; SRAM holds only the copy of
+    the selected descriptor.
+  - Selection is an index into the table (constant time, however many
+    folders / stations exist).
+  - A null renderer means that surface is dark for the theme (the
+    between-stations theme).
+  - A theme can be an EffectVM program instead of C++ code: the renderer is
+    the surface's renderProgram() and the row points at the program, so a
+    new simple theme costs its bytecode (tens of bytes) plus the row.
+  - A folder change is a crossfade, not a cut: the new theme is selected at
+    once and blend() rises from 0 to 255 over Config::THEME_FADE_MS. Each
+    surface snapshots its last frame at theme entry (RGB, reduced
+    resolution: 16 samples matrix / 15 strip, 93 bytes) and mixes it under
+    the new theme's frames by that weight.
+  - A program theme that repeats every beat (bakeBpm) is baked into
+    keyframes on entry and played back (Playback.h) instead of interpreted
+    every frame.
+
+ Usage:
+   Themes::select(folder);                 // once per loop, before the LEDs
+   const Themes::Theme &t = Themes::current();
+   if (t.renderMatrix) t.renderMatrix();
+*/
+
+namespace Themes {
+
+  enum DialMode : uint8_t {
+    DIAL_SOLID = 0,   // constant brightness
+    DIAL_BREATH,      // shared breath (matrix + strip + dial in sync)
+    DIAL_FLICKER      // random flicker (between stations)
+  };
+
+  typedef void (*Renderer)();
+
+  struct Theme {
+    Renderer renderMatrix;                      // nullptr = matrix dark
+    Renderer renderStrip;                       // nullptr = strip dark
+    const uint8_t *matrixProgram;               // EffectVM program (PROGMEM) for renderProgram()
+    const uint8_t *stripProgram;
+    FrameScheduler::Rate matrixRate;
+    FrameScheduler::Rate stripRate;
+    const TProgmemRGBPalette16 *stripPalette;   // index/value themes; nullptr = keep
+    uint16_t matrixStateBytes;                  // per-theme arena bytes zeroed on entry
+    uint16_t stripStateBytes;
+    DialMode dial;
+    uint8_t  bakeBpm;                           // programs periodic at this BPM: baked on entry (Playback); 0 = live
+  };
+
+  // Table index of the between-stations theme (folder 99 / unknown folders).
+  static const uint8_t BETWEEN_STATIONS = 0;
+
+  // Select the theme for folder (1..N; anything else = between stations).
+  // Copies the descriptor out of flash only when the theme changes, and
+  // (after boot) starts a crossfade. Call once per loop (advances it).
+  void select(uint8_t folder);
+
+  // Weight of the current theme over the previous theme's snapshot
+  // (Q8: 0 = previous frame only, 255 = no transition running).
+  uint8_t blend();
+
+  // Selected theme and its table index.
+  const Theme &current();
+  uint8_t currentId();
+
+  // Number of table entries (including BETWEEN_STATIONS).
+  uint8_t count();
+
+#if (DEBUG == 1) && (VM_BENCH == 1)
+  // Print native vs EffectVM render times for the themes that have both.
+  void benchmark();
+#endif
+}
@@ -5,6 +5,10 @@
 #include "Config.h"
 #include "LedMatrix.h"
 #include "LedStrip.h"
+#include "LedOutput.h"
+#include "NoiseField.h"
+#include "PhaseClock.h"
+#include "Themes.h"
 #include "DisplayLED.h"
 #include "Radio_Tuning.h"
 #include "MP3.h"
@@ -14,7 +18,7 @@
 // USER‑TWEAKABLE BRIGHTNESS (ALL IN ONE PLACE)
 // ============================================================
 
-// Matrix brightness (FastLED global)
+// Matrix + strip brightness (LedOutput global)
 static const uint8_t MATRIX_BRIGHT_NORMAL = 200;
 static const uint8_t MATRIX_BRIGHT_ALT    = 100;
 
@@ -45,6 +49,13 @@ static const uint8_t DIAL_F4_DIAL_MAX_NORMAL = 55;
 static const uint8_t DIAL_F4_DIAL_MIN_ALT    = 32;
 static const uint8_t DIAL_F4_DIAL_MAX_ALT    = 55;
 
+// ------------------------------------------------------------
+// Bluetooth idle visuals (party theme while BT is selected)
+// ------------------------------------------------------------
+// Paused: low-rate idle animation. Disconnected: hold the last frame.
+static const uint16_t BT_PAUSED_FRAME_MS       = 120;
+static const uint16_t BT_DISCONNECTED_FRAME_MS = LedMatrix::FRAME_HOLD;
+
 // Flicker behaviour (between stations)
 static const uint8_t  DIAL_FLICKER_MIN_NORMAL = 30;
 static const uint8_t  DIAL_FLICKER_MAX_NORMAL = 40;
@@ -137,8 +148,8 @@ static inline uint8_t dialBreathMapped(bool altMode) {
 
   const uint8_t range = (uint8_t)(dMax - dMin);
 
-  // 16-bit sine, phase-locked to millis() at DIAL_PULSE_BPM
-  const uint16_t wave16 = beatsin16(DIAL_PULSE_BPM, 0, 65535);
+  // 16-bit sine from the shared phase clock at DIAL_PULSE_BPM
+  const uint16_t wave16 = PhaseClock::beatsin16(DIAL_PULSE_BPM);
 
   // Convert to 0..255 shape (still for easing), but KEEP the full 16-bit wave for fraction.
   uint8_t shape8 = (uint8_t)(wave16 >> 8);
@@ -188,8 +199,14 @@ void setup() {
 
   LedMatrix::begin();
   LedStrip::begin();
-
-  FastLED.setMaxPowerInVoltsAndMilliamps(5, 1200);
+#if (DEBUG == 1) && (NOISE_BENCH == 1)
+  NoiseField::benchmark();
+  LedMatrix::benchmarkFire();
+  LedStrip::benchmarkEmbers();
+#endif
+#if (DEBUG == 1) && (VM_BENCH == 1)
+  Themes::benchmark();
+#endif
 
   DisplayLED::begin(Config::PIN_LED_DISPLAY);
 
@@ -199,7 +216,7 @@ void setup() {
 
   MP3::init();
 
-  FastLED.setBrightness(MATRIX_BRIGHT_NORMAL);
+  LedOutput::setBrightness(MATRIX_BRIGHT_NORMAL);
 
   DBG_BOOT(F("[BOOT] System ready"));
 }
@@ -209,6 +226,7 @@ void setup() {
 // ============================================================
 void loop() {
   const uint32_t now = millis();
+  PhaseClock::tick(now);
 
   // ----------------------------------------------------------
   // Display mode
@@ -220,12 +238,12 @@ void loop() {
     switch (g_displayMode) {
       case DISPLAY_NORMAL:
         DBG_SRC(F("Display mode: NORMAL"));
-        FastLED.setBrightness(MATRIX_BRIGHT_NORMAL);
+        LedOutput::setBrightness(MATRIX_BRIGHT_NORMAL);
         break;
 
       case DISPLAY_ALT:
         DBG_SRC(F("Display mode: ALTERNATE"));
-        FastLED.setBrightness(MATRIX_BRIGHT_ALT);
+        LedOutput::setBrightness(MATRIX_BRIGHT_ALT);
         break;
 
       case DISPLAY_OFF:
@@ -253,6 +271,23 @@ void loop() {
     }
   }
 
+  // ----------------------------------------------------------
+  // BT201 status (+ optional console passthrough, non-blocking)
+  // ----------------------------------------------------------
+  uint16_t ledFrameMs = 0; // 0 = scheduled per-theme rate
+  if (g_sourceMode == SOURCE_BT) {
+#if BT_PASSTHROUGH == 1
+    g_bt.passthrough();
+#else
+    g_bt.poll();
+#endif
+    switch (g_bt.playState()) {
+      case BluetoothModule::BT_STATE_DISCONNECTED: ledFrameMs = BT_DISCONNECTED_FRAME_MS; break;
+      case BluetoothModule::BT_STATE_PAUSED:       ledFrameMs = BT_PAUSED_FRAME_MS; break;
+      default: break; // playing / unknown: no slow-down
+    }
+  }
+
   // ----------------------------------------------------------
   // Next-track button debounce
   // ----------------------------------------------------------
@@ -299,6 +334,13 @@ void loop() {
     MP3::tick();
   }
 
+  // ----------------------------------------------------------
+  // Theme (one table lookup drives dial, matrix and strip; folder changes
+  // crossfade, see Themes::blend())
+  // ----------------------------------------------------------
+  Themes::select(g_folder);
+  const Themes::DialMode dialMode = Themes::current().dial;
+
   // ----------------------------------------------------------
   // Dial LED + shared Folder 4 breath
   // ----------------------------------------------------------
@@ -308,7 +350,7 @@ void loop() {
     LedStrip::setSpookyBreath(0xFF);
     resetSpookyBreathSmoother();
     g_dialDitherErr16 = 0;
-  } else if (g_folder == 99) {
+  } else if (dialMode == Themes::DIAL_FLICKER) {
     DisplayLED::flickerRandomTick(
       altMode ? DIAL_FLICKER_MIN_ALT : DIAL_FLICKER_MIN_NORMAL,
       altMode ? DIAL_FLICKER_MAX_ALT : DIAL_FLICKER_MAX_NORMAL,
@@ -318,9 +360,9 @@ void loop() {
     LedStrip::setSpookyBreath(0xFF);
     resetSpookyBreathSmoother();
     g_dialDitherErr16 = 0;
-  } else if (g_folder == 4) {
+  } else if (dialMode == Themes::DIAL_BREATH) {
     // Matrix/strip keep existing shared breath (unchanged)
-    const uint8_t rawBreath = beatsin8(
+    const uint8_t rawBreath = PhaseClock::beatsin8(
       DIAL_PULSE_BPM,
       altMode ? DIAL_PULSE_MIN_ALT : DIAL_PULSE_MIN_NORMAL,
       altMode ? DIAL_PULSE_MAX_ALT : DIAL_PULSE_MAX_NORMAL
@@ -346,7 +388,9 @@ void loop() {
   // LEDs: skip updates on the RC-measurement iteration
   // ----------------------------------------------------------
   if (!didTunePollThisLoop) {
-    LedStrip::update(g_folder, lightsOn);
-    LedMatrix::update(g_folder, lightsOn);
+    LedStrip::setFrameInterval(ledFrameMs);
+    LedMatrix::setFrameInterval(ledFrameMs);
+    LedStrip::update(lightsOn);
+    LedMatrix::update(lightsOn);
   }
 }
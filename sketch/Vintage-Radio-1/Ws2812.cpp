@@ -0,0 +1,62 @@
+// Ws2812.cpp
+#include "Ws2812.h"
+
+#if defined(__AVR__)
+// Arduino core Timer0 counters (wiring.c); adjusted after each frame.
+extern volatile unsigned long timer0_millis;
+extern volatile unsigned long timer0_overflow_count;
+#endif
+
+namespace Ws2812 {
+
+  Writer::Writer(uint8_t pin)
+   : _pin(pin),
+     _port(nullptr),
+     _mask(0),
+     _hi(0),
+     _lo(0),
+     _sreg(0),
+     _tcnt0(0),
+     _bytes(0),
+     _carryUs(0) {
+  }
+
+  void Writer::init() {
+    pinMode(_pin, OUTPUT);
+    digitalWrite(_pin, LOW);
+#if defined(__AVR__)
+    _port = portOutputRegister(digitalPinToPort(_pin));
+    _mask = digitalPinToBitMask(_pin);
+#endif
+  }
+
+  void Writer::begin() {
+    _bytes = 0;
+#if defined(__AVR__)
+    _sreg = SREG;
+    cli();
+    _tcnt0 = TCNT0;
+    // Sample the port once with interrupts off so other pins on it keep their state.
+    _hi = (uint8_t)(*_port | _mask);
+    _lo = (uint8_t)(*_port & ~_mask);
+#endif
+  }
+
+  void Writer::end() {
+#if defined(__AVR__)
+    // Give back the Timer0 overflows lost while interrupts were off. Timer0
+    // ticks every 4 us (prescaler 64), so the frame crossed
+    // (start count + frameUs / 4) / 256 overflows; the overflow interrupt
+    // pending on SREG restore counts the first of them itself.
+    const uint32_t frameUs = ((uint32_t)_bytes * BYTE_TIME_US_X16) >> 4;
+    uint16_t lost = (uint16_t)((_tcnt0 + (frameUs >> 2)) >> 8);
+    if (lost > 0) lost--;
+    timer0_overflow_count += lost;
+    const uint32_t lostUs = ((uint32_t)lost << 10) + _carryUs;
+    timer0_millis += lostUs / 1000UL;
+    _carryUs = (uint16_t)(lostUs % 1000UL);
+    SREG = _sreg;
+#endif
+  }
+
+} // namespace Ws2812
@@ -0,0 +1,110 @@
+// Ws2812.h
+#pragma once
+#include <Arduino.h>
+
+/*
+ ============================================================
+ Streaming WS2812B output (AVR, 16 MHz)
+ ============================================================
+ Minimal bit-banged WS2812B writer that is fed one pixel at a time, so the
+ caller can expand compact buffers (e.g. one colour per matrix column)
+ while streaming instead of keeping a full per-LED CRGB array in SRAM.
+
+ Usage:
+   Ws2812::Writer w(pin);        // once (pin set to OUTPUT LOW by begin())
+   w.begin();                    // per frame: interrupts off
+   w.pixel(r, g, b);             // xN, already brightness-scaled
+   w.end();                      // interrupts restored, millis()/micros() compensated
+
+ Timing (16 MHz, one bit = 20 cycles = 1.25 us):
+  - '0' bit high for ~6 cycles (0.375 us), '1' bit high for ~13 cycles (0.81 us).
+  - The line idles LOW between bytes/pixels, so C code between pixel() calls
+    only stretches the low phase. Real WS2812B parts stop reading data after
+    ~5 us low and latch at ~6 us (the datasheet's 50 / 280 us reset is the
+    minimum a sender must hold to latch, not a gap that is safe to leave),
+    so keep that work to ~3 us per pixel or less. Do any expensive
+    per-frame work before begin(). The heaviest user is LedStrip's palette
+    table lookup, about 2 us.
+  - Wire order is GRB (WS2812B).
+
+ Interrupts:
+  - Disabled from begin() to end() (the protocol cannot tolerate ISR gaps).
+    Timer0 overflows (one per 1024 us) are lost meanwhile, except the one
+    the pending overflow interrupt catches up when interrupts come back.
+    end() adds the others back to the overflow count micros() reads and
+    their time to millis(), as FastLED does for its AVR clockless
+    controllers, so a push shows up in micros()-based frame costs.
+
+ Non-AVR builds (host tools) compile to a no-op writer.
+*/
+
+namespace Ws2812 {
+
+  // Approximate time per byte including the C work between pixels (us x 16):
+  // 10 us on the wire + ~1 us call overhead + ~2/3 us for the worst
+  // per-pixel expansion (LedStrip, ~2 us per 3 bytes).
+  static const uint16_t BYTE_TIME_US_X16 = 187; // ~11.7 us
+
+  class Writer {
+  public:
+    explicit Writer(uint8_t pin);
+
+    // Configure the pin as OUTPUT LOW. Call once from setup().
+    void init();
+
+    void begin();
+    void end();
+
+    inline void pixel(uint8_t r, uint8_t g, uint8_t b) {
+      sendByte(g);
+      sendByte(r);
+      sendByte(b);
+      _bytes += 3;
+    }
+
+  private:
+    uint8_t _pin;
+    volatile uint8_t *_port;
+    uint8_t _mask;
+    uint8_t _hi;
+    uint8_t _lo;
+    uint8_t _sreg;
+    uint8_t _tcnt0;    // Timer0 count at begin() (phase of the next overflow)
+    uint16_t _bytes;
+    uint16_t _carryUs; // sub-millisecond remainder of the millis() correction
+
+    inline void sendByte(uint8_t b) {
+#if defined(__AVR__)
+      uint8_t bit = 8;
+      uint8_t next;
+      // Cycle counts from the rising edge (end of the first st).
+      asm volatile(
+        "1:"                          "\n\t"
+        "st   %a[port], %[hi]"        "\n\t" // 2   line HIGH          (T = 0)
+        "mov  %[next], %[lo]"         "\n\t" // 1                      (T = 1)
+        "sbrc %[byte], 7"             "\n\t" // 1-2 if (b & 0x80)
+        "mov  %[next], %[hi]"         "\n\t" // 1     next = hi        (T = 3)
+        "nop"                         "\n\t" // 1                      (T = 4)
+        "st   %a[port], %[next]"      "\n\t" // 2   '0' bits fall      (T = 6)
+        "lsl  %[byte]"                "\n\t" // 1                      (T = 7)
+        "dec  %[bit]"                 "\n\t" // 1                      (T = 8)
+        "rjmp .+0"                    "\n\t" // 2                      (T = 10)
+        "nop"                         "\n\t" // 1                      (T = 11)
+        "st   %a[port], %[lo]"        "\n\t" // 2   '1' bits fall      (T = 13)
+        "rjmp .+0"                    "\n\t" // 2                      (T = 15)
+        "nop"                         "\n\t" // 1                      (T = 16)
+        "brne 1b"                     "\n\t" // 2   next bit           (T = 18 -> 20)
+        : [byte] "+r" (b),
+          [bit]  "+r" (bit),
+          [next] "=&r" (next)
+        : [port] "e" (_port),
+          [hi]   "r" (_hi),
+          [lo]   "r" (_lo)
+      );
+#else
+      (void)b;
+#endif
+    }
+  };
+
+} // namespace Ws2812
@@ -0,0 +1,162 @@
+// BT201Emu.cpp
+#include "BT201Emu.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace {
+  // CT baud codes (AT+CT04 = 57600 is what the sketch runs at).
+  long baudForCode(uint8_t code) {
+    switch (code) {
+      case 1: return 9600;
+      case 2: return 19200;
+      case 3: return 38400;
+      case 4: return 57600;
+      case 5: return 115200;
+      default: return 0;
+    }
+  }
+
+  bool parse2(const std::string &arg, uint8_t maxVal, uint8_t &out) {
+    if (arg.size() != 2) return false;
+    if (arg[0] < '0' || arg[0] > '9' || arg[1] < '0' || arg[1] > '9') return false;
+    const uint8_t v = (uint8_t)((arg[0] - '0') * 10 + (arg[1] - '0'));
+    if (v > maxVal) return false;
+    out = v;
+    return true;
+  }
+}
+
+BT201Emu::BT201Emu(long baud)
+ : _baud(baud),
+   _arduinoRxPin(255),
+   _replyMinMs(8),
+   _replyMaxMs(30),
+   _errPermille(0),
+   _rng(0x1234567u),
+   _txFreeUs(0) {
+  _state.baudCode = 4;
+  _state.name = "BT201";
+  _state.autoSwitch = 1;
+  _state.callEnabled = 1;
+  _state.volume = 15;
+  _state.prompts = 1;
+  _state.eq = 0;
+  resetStats();
+}
+
+void BT201Emu::attach(uint8_t arduinoRxPin, uint8_t arduinoTxPin) {
+  _arduinoRxPin = arduinoRxPin;
+  HostSim::attachDevice(arduinoRxPin, arduinoTxPin, *this);
+}
+
+void BT201Emu::setReplyLatencyMs(uint16_t minMs, uint16_t maxMs) {
+  _replyMinMs = minMs;
+  _replyMaxMs = (maxMs < minMs) ? minMs : maxMs;
+}
+
+void BT201Emu::setErrPermille(uint16_t permille) { _errPermille = (permille > 1000) ? 1000 : permille; }
+void BT201Emu::seed(uint32_t s) { _rng = s ? s : 1; }
+
+void BT201Emu::resetStats() {
+  _stats.commands = 0;
+  _stats.ok = 0;
+  _stats.err = 0;
+  _stats.injected = 0;
+  _stats.rxBytes = 0;
+}
+
+uint32_t BT201Emu::nextRand() {
+  // xorshift32: deterministic runs for a given seed
+  _rng ^= _rng << 13;
+  _rng ^= _rng >> 17;
+  _rng ^= _rng << 5;
+  return _rng;
+}
+
+void BT201Emu::emitLine(const char *line, uint16_t delayMs) {
+  queueText(std::string(line) + "\r\n", HostSim::nowUs() + (uint64_t)delayMs * 1000ULL);
+}
+
+void BT201Emu::onByte(uint8_t b, uint64_t nowUs) {
+  _stats.rxBytes++;
+  if (b == '\r') return;
+  if (b != '\n') {
+    if (_line.size() < 96) _line.push_back((char)b);
+    return;
+  }
+  if (!_line.empty()) handleLine(_line, nowUs);
+  _line.clear();
+}
+
+void BT201Emu::tick(uint64_t nowUs) {
+  while (!_tx.empty() && _tx.front().dueUs <= nowUs) {
+    HostSim::driveRx(_arduinoRxPin, _tx.front().b);
+    _tx.pop_front();
+  }
+}
+
+void BT201Emu::handleLine(const std::string &line, uint64_t nowUs) {
+  _stats.commands++;
+
+  const uint16_t span = (uint16_t)(_replyMaxMs - _replyMinMs);
+  const uint16_t latencyMs = (uint16_t)(_replyMinMs + (span ? nextRand() % (span + 1) : 0));
+  const uint64_t startUs = nowUs + (uint64_t)latencyMs * 1000ULL;
+
+  std::string reply;
+  bool ok = false;
+  if (line.size() >= 5 && line.compare(0, 3, "AT+") == 0) {
+    if (_errPermille && (nextRand() % 1000) < _errPermille) {
+      _stats.injected++;
+    } else {
+      ok = apply(line.substr(3, 2), line.substr(5), reply);
+    }
+  }
+
+  if (ok) {
+    _stats.ok++;
+    queueText(reply.empty() ? std::string("OK\r\n") : reply, startUs);
+  } else {
+    _stats.err++;
+    queueText("ERR\r\n", startUs);
+  }
+}
+
+bool BT201Emu::apply(const std::string &code, const std::string &arg, std::string &reply) {
+  uint8_t v = 0;
+  if (code == "CT") {
+    if (!parse2(arg, 5, v) || baudForCode(v) == 0) return false;
+    _state.baudCode = v;
+    return true;
+  }
+  if (code == "BD") {
+    if (arg.empty() || arg.size() > 32) return false;
+    _state.name = arg;
+    return true;
+  }
+  if (code == "CK") { if (!parse2(arg, 1, v)) return false; _state.autoSwitch = v; return true; }
+  if (code == "B2") { if (!parse2(arg, 1, v)) return false; _state.callEnabled = v; return true; }
+  if (code == "CA") { if (!parse2(arg, 30, v)) return false; _state.volume = v; return true; }
+  if (code == "CN") { if (!parse2(arg, 1, v)) return false; _state.prompts = v; return true; }
+  if (code == "CQ") { if (!parse2(arg, 5, v)) return false; _state.eq = v; return true; }
+  if (code == "QA" && arg.empty()) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "QA+%02u\r\n", (unsigned)_state.volume);
+    reply = buf;
+    return true;
+  }
+  return false;
+}
+
+void BT201Emu::queueText(const std::string &text, uint64_t startUs) {
+  const uint64_t byteUs = (uint64_t)(10000000L / _baud);
+  uint64_t t = (startUs > _txFreeUs) ? startUs : _txFreeUs;
+  for (size_t i = 0; i < text.size(); ++i) {
+    t += byteUs;
+    Pending p = { t, (uint8_t)text[i] };
+    // Keep the queue ordered (notifications may be scheduled out of order).
+    std::deque<Pending>::iterator it = _tx.end();
+    while (it != _tx.begin() && (it - 1)->dueUs > t) --it;
+    _tx.insert(it, p);
+  }
+  _txFreeUs = t;
+}
@@ -0,0 +1,89 @@
+// BT201Emu.h
+#pragma once
+#include "host/HostSim.h"
+#include <deque>
+#include <string>
+
+/*
+ ============================================================
+ Fake BT201 (AT-command side only)
+ ============================================================
+ Accepts the AT commands BluetoothModule sends and answers like the module:
+  - "OK\r\n" when the command is accepted (state is updated)
+  - "ERR\r\n" for unknown commands, bad parameters, or injected errors
+
+ Timing:
+  - Reply starts replyMinMs..replyMaxMs after the command's '\n'.
+  - Reply bytes are spaced by one character time at the configured baud.
+
+ Known commands (state kept across commands):
+  CT baud code, BD device name, CK auto-switch, B2 call functions,
+  CA volume (00..30), CN prompts, CQ EQ (00..05), QA volume query.
+*/
+
+class BT201Emu : public HostSim::Device {
+public:
+  struct State {
+    uint8_t baudCode;
+    std::string name;
+    uint8_t autoSwitch;
+    uint8_t callEnabled;
+    uint8_t volume;
+    uint8_t prompts;
+    uint8_t eq;
+  };
+
+  struct Stats {
+    uint32_t commands;  // complete lines received
+    uint32_t ok;
+    uint32_t err;       // all ERR replies
+    uint32_t injected;  // ERR replies caused by errPermille
+    uint32_t rxBytes;
+  };
+
+  explicit BT201Emu(long baud);
+
+  // Timing / fault injection
+  void setReplyLatencyMs(uint16_t minMs, uint16_t maxMs);
+  void setErrPermille(uint16_t permille); // 0..1000 chance of a spurious ERR
+  void seed(uint32_t s);
+
+  // Queue an unsolicited status line (e.g. "TS+02" when playback starts).
+  void emitLine(const char *line, uint16_t delayMs);
+
+  const State &state() const { return _state; }
+  const Stats &stats() const { return _stats; }
+  void resetStats();
+
+  // HostSim::Device
+  void onByte(uint8_t b, uint64_t nowUs) override;
+  void tick(uint64_t nowUs) override;
+
+  // Pins as seen from the firmware (Arduino RX <- module TX).
+  void attach(uint8_t arduinoRxPin, uint8_t arduinoTxPin);
+
+private:
+  struct Pending {
+    uint64_t dueUs;
+    uint8_t b;
+  };
+
+  long _baud;
+  uint8_t _arduinoRxPin;
+  uint16_t _replyMinMs;
+  uint16_t _replyMaxMs;
+  uint16_t _errPermille;
+  uint32_t _rng;
+
+  std::string _line;
+  std::deque<Pending> _tx;
+  uint64_t _txFreeUs; // earliest time the module's TX line is idle
+
+  State _state;
+  Stats _stats;
+
+  uint32_t nextRand();
+  void handleLine(const std::string &line, uint64_t nowUs);
+  bool apply(const std::string &code, const std::string &arg, std::string &reply);
+  void queueText(const std::string &text, uint64_t startUs);
+};
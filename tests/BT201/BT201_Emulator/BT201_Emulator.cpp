@@ -0,0 +1,185 @@
+// BT201_Emulator.cpp
+/*
+ ============================================================
+ Host-side BT201 emulator harness
+ ============================================================
+ Runs the real sketch Bluetooth.cpp + SerialBus.cpp on a PC against a fake
+ BT201 (BT201Emu) through a SoftwareSerial/Arduino shim with a virtual clock.
+ No module or Nano required.
+
+ Measures:
+  1) Boot cost of BluetoothModule::begin() + sendInitialCommands()
+  2) Retry behaviour with injected ERR replies
+  3) Passthrough throughput while loop() also spends time on LED work,
+     for paced (scripted) and pasted console input
+  4) Play-state tracking from pushed "TS+xx" status lines
+
+ Build + run (from this folder):
+   g++ -std=gnu++11 -O2 -I host -I ../../../sketch/Vintage-Radio-1 \
+     BT201_Emulator.cpp BT201Emu.cpp host/HostSim.cpp \
+     ../../../sketch/Vintage-Radio-1/Bluetooth.cpp \
+     ../../../sketch/Vintage-Radio-1/SerialBus.cpp -o bt201_emu
+   ./bt201_emu [errPermille] [seed]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+#include "host/HostSim.h"
+#include "BT201Emu.h"
+#include "Config.h"
+#include "Bluetooth.h"
+#include "SerialBus.h"
+
+static const uint8_t INIT_COMMAND_COUNT = 7; // lines sent by sendInitialCommands()
+
+static BluetoothModule g_bt(Config::PIN_BT_RX, Config::PIN_BT_TX);
+static BT201Emu g_emu(Config::BT_BAUD);
+
+static double msSince(uint64_t t0Us) {
+  return (double)(HostSim::nowUs() - t0Us) / 1000.0;
+}
+
+static void printState() {
+  const BT201Emu::State &st = g_emu.state();
+  printf("  module state : name=\"%s\" CT=%02u CK=%02u B2=%02u CA=%02u CN=%02u CQ=%02u\n",
+         st.name.c_str(), st.baudCode, st.autoSwitch, st.callEnabled,
+         st.volume, st.prompts, st.eq);
+}
+
+static void scenarioBoot() {
+  printf("[1] Boot: begin() + sendInitialCommands(), no errors\n");
+  g_emu.setErrPermille(0);
+  g_emu.resetStats();
+
+  const uint64_t t0 = HostSim::nowUs();
+  g_bt.begin(Config::BT_BAUD);
+  g_bt.sendInitialCommands();
+  const double ms = msSince(t0);
+
+  const BT201Emu::Stats &s = g_emu.stats();
+  printf("  boot time    : %.1f ms for %u commands (%.1f ms/command)\n",
+         ms, (unsigned)s.commands, s.commands ? ms / s.commands : 0.0);
+  printf("  replies      : %u OK, %u ERR\n", (unsigned)s.ok, (unsigned)s.err);
+  printState();
+}
+
+static void scenarioRetries(uint16_t errPermille) {
+  printf("[2] Retries: %u/1000 injected ERR replies\n", (unsigned)errPermille);
+  g_emu.setErrPermille(errPermille);
+  g_emu.resetStats();
+
+  const uint64_t t0 = HostSim::nowUs();
+  g_bt.sendInitialCommands();
+  const double ms = msSince(t0);
+
+  const BT201Emu::Stats &s = g_emu.stats();
+  const unsigned retries = (s.commands > INIT_COMMAND_COUNT) ? (unsigned)(s.commands - INIT_COMMAND_COUNT) : 0;
+  printf("  time         : %.1f ms\n", ms);
+  printf("  sent         : %u lines (%u retries), %u injected ERR\n",
+         (unsigned)s.commands, retries, (unsigned)s.injected);
+  printf("  gave up      : %u commands (OK replies %u of %u)\n",
+         (unsigned)(INIT_COMMAND_COUNT > s.ok ? INIT_COMMAND_COUNT - s.ok : 0),
+         (unsigned)s.ok, (unsigned)INIT_COMMAND_COUNT);
+  printState();
+  g_emu.setErrPermille(0);
+}
+
+static void scenarioPassthrough(uint32_t lineIntervalUs) {
+  const unsigned LINES = 40;
+  const uint32_t LOOP_WORK_US = 12000; // stand-in for LED render + show per loop()
+
+  printf("[3] Passthrough: %u console lines, one every %.1f ms, %.1f ms other work per loop()\n",
+         LINES, lineIntervalUs / 1000.0, LOOP_WORK_US / 1000.0);
+  g_emu.resetStats();
+  (void)HostSim::consoleTakeOutput();
+  const uint32_t droppedBefore = HostSim::consoleRxDropped();
+
+  const uint64_t t0 = HostSim::nowUs();
+  uint64_t nextLineUs = t0;
+  unsigned typed = 0;
+  uint64_t worstCallUs = 0;
+  uint32_t loops = 0;
+  size_t consoleBytes = 0;
+  uint64_t idleSinceUs = t0;
+
+  // Run until all lines are typed and the link has been quiet for 500 ms.
+  while (loops < 100000) {
+    while (typed < LINES && HostSim::nowUs() >= nextLineUs) {
+      char line[24];
+      snprintf(line, sizeof(line), "AT+CA%02u\r\n", typed % 31);
+      HostSim::consoleType(line);
+      typed++;
+      nextLineUs += lineIntervalUs;
+    }
+
+    const uint32_t rxBefore = g_emu.stats().rxBytes;
+    const uint64_t c0 = HostSim::nowUs();
+    g_bt.passthrough();
+    const uint64_t callUs = HostSim::nowUs() - c0;
+    if (callUs > worstCallUs) worstCallUs = callUs;
+
+    HostSim::advanceUs(LOOP_WORK_US);
+    const size_t back = HostSim::consoleTakeOutput().size();
+    consoleBytes += back;
+    loops++;
+
+    if (back > 0 || g_emu.stats().rxBytes != rxBefore || HostSim::consoleInputPending() > 0) {
+      idleSinceUs = HostSim::nowUs();
+    } else if (typed == LINES && HostSim::nowUs() - idleSinceUs > 500000ULL) {
+      break;
+    }
+  }
+
+  const double ms = (double)(idleSinceUs - t0) / 1000.0;
+  const BT201Emu::Stats &s = g_emu.stats();
+  printf("  elapsed      : %.1f ms over %lu loop() iterations\n", ms, (unsigned long)loops);
+  printf("  to module    : %u of %u lines, %u bytes (%.0f B/s)\n",
+         (unsigned)s.commands, LINES, (unsigned)s.rxBytes, ms > 0 ? s.rxBytes * 1000.0 / ms : 0.0);
+  printf("  to console   : %u bytes (%u OK, %u ERR replies)\n",
+         (unsigned)consoleBytes, (unsigned)s.ok, (unsigned)s.err);
+  printf("  console drop : %u bytes lost to a full USB RX buffer\n",
+         (unsigned)(HostSim::consoleRxDropped() - droppedBefore));
+  printf("  worst call   : %.2f ms inside passthrough()\n", worstCallUs / 1000.0);
+  printf("  bus          : %u bytes lost on listener switch, %u overflows\n",
+         (unsigned)SerialBus::lostBytes(), (unsigned)SerialBus::overflowCount());
+}
+
+static const char *playStateName(BluetoothModule::PlayState st) {
+  switch (st) {
+    case BluetoothModule::BT_STATE_DISCONNECTED: return "disconnected";
+    case BluetoothModule::BT_STATE_PAUSED:       return "paused";
+    case BluetoothModule::BT_STATE_PLAYING:      return "playing";
+    default:                                     return "unknown";
+  }
+}
+
+static void scenarioStatus() {
+  static const char *const LINES[] = { "TS+01", "TS+02", "TS+01", "TS+00" };
+
+  printf("[4] Status notifications parsed by poll()\n");
+  for (unsigned i = 0; i < sizeof(LINES) / sizeof(LINES[0]); ++i) {
+    g_emu.emitLine(LINES[i], 5);
+    for (uint8_t n = 0; n < 10; ++n) {
+      g_bt.poll();
+      HostSim::advanceUs(5000);
+    }
+    printf("  %s -> %s\n", LINES[i], playStateName(g_bt.playState()));
+  }
+}
+
+int main(int argc, char **argv) {
+  const uint16_t errPermille = (argc > 1) ? (uint16_t)atoi(argv[1]) : 150;
+  const uint32_t seed = (argc > 2) ? (uint32_t)strtoul(argv[2], nullptr, 10) : 1;
+
+  g_emu.seed(seed);
+  g_emu.attach(Config::PIN_BT_RX, Config::PIN_BT_TX);
+
+  scenarioBoot();
+  scenarioRetries(errPermille);
+  scenarioPassthrough(25000); // scripted, paced input
+  scenarioPassthrough(800);   // pasted block: shows where the USB RX buffer overflows
+  scenarioStatus();
+  return 0;
+}
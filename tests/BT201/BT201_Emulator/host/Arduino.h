@@ -0,0 +1,84 @@
+// Arduino.h (host shim)
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ ============================================================
+ Minimal Arduino core shim for host builds
+ ============================================================
+ Just enough of the AVR core for Bluetooth.cpp / SerialBus.cpp to compile
+ and run on a PC against the BT201 emulator.
+
+ Time is virtual (see HostSim.h):
+  - delay()/delayMicroseconds() advance the clock.
+  - millis()/micros() also advance it by a few microseconds per call, so
+    firmware busy-wait loops make progress just like on the Nano.
+*/
+
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define A0 14
+
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+
+  size_t write(const uint8_t *buf, size_t n);
+  size_t print(const char *s);
+  size_t print(const __FlashStringHelper *s);
+  size_t print(char c);
+  size_t print(long v, int base = DEC);
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned long v, int base = DEC) { return print((long)v, base); }
+  size_t println();
+  template <typename T> size_t println(T v) { const size_t n = print(v); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+// USB Serial: input is injected by the harness, output is captured.
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud);
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t b) override;
+  using Print::write;
+  int availableForWrite();
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,241 @@
+// HostSim.cpp
+#include "HostSim.h"
+#include <SoftwareSerial.h>
+#include <deque>
+#include <vector>
+#include <stdio.h>
+
+namespace {
+  uint64_t g_nowUs = 0;
+
+  struct Wire {
+    uint8_t rxPin;
+    uint8_t txPin;
+    HostSim::Device *dev;
+  };
+  std::vector<Wire> &wires() {
+    static std::vector<Wire> s_wires;
+    return s_wires;
+  }
+
+  // SoftwareSerial shared state (mirrors the AVR library)
+  const uint8_t SS_MAX_RX_BUFF = 64;
+  // Function-local so global SoftwareSerial objects in other translation
+  // units can register before this file's statics are constructed.
+  std::vector<SoftwareSerial *> &ports() {
+    static std::vector<SoftwareSerial *> s_ports;
+    return s_ports;
+  }
+  SoftwareSerial *g_listener = nullptr;
+  std::deque<uint8_t> g_ssRx;
+  bool g_ssOverflow = false;
+
+  // USB Serial (115200 baud, 64-byte RX and TX buffers)
+  const uint32_t USB_BYTE_US = 87;
+  const uint8_t USB_TX_BUFF = 64;
+  const uint8_t USB_RX_BUFF = 64;
+  std::deque<uint8_t> g_usbBacklog;   // typed on the PC, still on the wire
+  uint64_t g_usbNextRxUs = 0;
+  uint32_t g_usbRxDropped = 0;
+  std::deque<uint8_t> g_usbIn;        // in the Nano's RX buffer
+  std::string g_usbOut;
+  uint32_t g_usbTxPending = 0;
+  uint64_t g_usbLastDrainUs = 0;
+
+  // PC -> Nano at line rate; bytes are lost if the sketch does not keep up.
+  void feedUsbRx() {
+    while (!g_usbBacklog.empty() && g_usbNextRxUs <= g_nowUs) {
+      if (g_usbIn.size() < (size_t)(USB_RX_BUFF - 1)) g_usbIn.push_back(g_usbBacklog.front());
+      else g_usbRxDropped++;
+      g_usbBacklog.pop_front();
+      g_usbNextRxUs += USB_BYTE_US;
+    }
+  }
+
+  void drainUsbTx() {
+    const uint64_t drained = (g_nowUs - g_usbLastDrainUs) / USB_BYTE_US;
+    if (drained == 0) return;
+    g_usbLastDrainUs += drained * USB_BYTE_US;
+    g_usbTxPending = (drained >= g_usbTxPending) ? 0 : (uint32_t)(g_usbTxPending - drained);
+  }
+}
+
+// ------------------------------------------------------------
+// HostSim
+// ------------------------------------------------------------
+uint64_t HostSim::nowUs() { return g_nowUs; }
+
+void HostSim::advanceUs(uint64_t us) {
+  while (us > 0) {
+    const uint64_t step = (us > 100) ? 100 : us;
+    g_nowUs += step;
+    us -= step;
+    for (size_t i = 0; i < wires().size(); ++i) wires()[i].dev->tick(g_nowUs);
+    feedUsbRx();
+  }
+  drainUsbTx();
+}
+
+void HostSim::attachDevice(uint8_t arduinoRxPin, uint8_t arduinoTxPin, Device &dev) {
+  Wire w = { arduinoRxPin, arduinoTxPin, &dev };
+  wires().push_back(w);
+}
+
+void HostSim::driveRx(uint8_t arduinoRxPin, uint8_t b) {
+  for (size_t i = 0; i < ports().size(); ++i) {
+    if (ports()[i]->rxPin() == arduinoRxPin) ports()[i]->deliver(b);
+  }
+}
+
+void HostSim::firmwareTx(uint8_t arduinoTxPin, uint8_t b) {
+  for (size_t i = 0; i < wires().size(); ++i) {
+    if (wires()[i].txPin == arduinoTxPin) wires()[i].dev->onByte(b, g_nowUs);
+  }
+}
+
+void HostSim::consoleType(const char *text) {
+  if (g_usbBacklog.empty() && g_usbNextRxUs < g_nowUs) g_usbNextRxUs = g_nowUs;
+  while (*text) g_usbBacklog.push_back((uint8_t)*text++);
+}
+
+std::string HostSim::consoleTakeOutput() {
+  std::string out;
+  out.swap(g_usbOut);
+  return out;
+}
+
+uint32_t HostSim::consoleInputPending() { return (uint32_t)(g_usbBacklog.size() + g_usbIn.size()); }
+uint32_t HostSim::consoleRxDropped() { return g_usbRxDropped; }
+
+// ------------------------------------------------------------
+// Arduino core
+// ------------------------------------------------------------
+unsigned long micros() {
+  HostSim::advanceUs(HostSim::CLOCK_READ_COST_US);
+  return (unsigned long)g_nowUs;
+}
+
+unsigned long millis() {
+  HostSim::advanceUs(HostSim::CLOCK_READ_COST_US);
+  return (unsigned long)(g_nowUs / 1000ULL);
+}
+
+void delay(unsigned long ms) { HostSim::advanceUs((uint64_t)ms * 1000ULL); }
+void delayMicroseconds(unsigned int us) { HostSim::advanceUs(us); }
+
+void pinMode(uint8_t, uint8_t) {}
+int digitalRead(uint8_t) { return HIGH; }
+void digitalWrite(uint8_t, uint8_t) {}
+
+size_t Print::write(const uint8_t *buf, size_t n) {
+  for (size_t i = 0; i < n; ++i) write(buf[i]);
+  return n;
+}
+size_t Print::print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+size_t Print::print(const __FlashStringHelper *s) { return print(reinterpret_cast<const char *>(s)); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(long v, int base) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), (base == HEX) ? "%lX" : "%ld", v);
+  return print(buf);
+}
+size_t Print::println() { return print("\r\n"); }
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long) {}
+int HardwareSerial::available() { return (int)g_usbIn.size(); }
+int HardwareSerial::read() {
+  if (g_usbIn.empty()) return -1;
+  const uint8_t b = g_usbIn.front();
+  g_usbIn.pop_front();
+  return b;
+}
+int HardwareSerial::peek() { return g_usbIn.empty() ? -1 : g_usbIn.front(); }
+int HardwareSerial::availableForWrite() {
+  drainUsbTx();
+  return (int)(USB_TX_BUFF - 1) - (int)g_usbTxPending;
+}
+size_t HardwareSerial::write(uint8_t b) {
+  // Blocks (like the AVR core) only when the TX buffer is full.
+  while (availableForWrite() <= 0) HostSim::advanceUs(USB_BYTE_US);
+  g_usbTxPending++;
+  g_usbOut.push_back((char)b);
+  return 1;
+}
+
+// ------------------------------------------------------------
+// SoftwareSerial
+// ------------------------------------------------------------
+SoftwareSerial::SoftwareSerial(uint8_t rxPin, uint8_t txPin, bool)
+ : _rxPin(rxPin), _txPin(txPin), _baud(0) {
+  ports().push_back(this);
+}
+
+SoftwareSerial::~SoftwareSerial() {
+  for (size_t i = 0; i < ports().size(); ++i) {
+    if (ports()[i] == this) { ports().erase(ports().begin() + i); break; }
+  }
+  if (g_listener == this) g_listener = nullptr;
+}
+
+void SoftwareSerial::begin(long baud) {
+  _baud = baud;
+  listen();
+}
+
+void SoftwareSerial::end() { stopListening(); }
+
+bool SoftwareSerial::listen() {
+  if (_baud <= 0) return false;
+  if (g_listener == this) return false;
+  g_ssRx.clear();
+  g_ssOverflow = false;
+  g_listener = this;
+  return true;
+}
+
+bool SoftwareSerial::stopListening() {
+  if (g_listener != this) return false;
+  g_listener = nullptr;
+  return true;
+}
+
+bool SoftwareSerial::isListening() { return g_listener == this; }
+
+bool SoftwareSerial::overflow() {
+  const bool ret = g_ssOverflow && g_listener == this;
+  if (ret) g_ssOverflow = false;
+  return ret;
+}
+
+int SoftwareSerial::available() { return (g_listener == this) ? (int)g_ssRx.size() : 0; }
+
+int SoftwareSerial::read() {
+  if (g_listener != this || g_ssRx.empty()) return -1;
+  const uint8_t b = g_ssRx.front();
+  g_ssRx.pop_front();
+  return b;
+}
+
+int SoftwareSerial::peek() {
+  if (g_listener != this || g_ssRx.empty()) return -1;
+  return g_ssRx.front();
+}
+
+size_t SoftwareSerial::write(uint8_t b) {
+  if (_baud <= 0) return 0;
+  // TX is bit-banged with interrupts off: the caller is blocked for 10 bit times.
+  HostSim::advanceUs((uint64_t)(10000000L / _baud));
+  HostSim::firmwareTx(_txPin, b);
+  return 1;
+}
+
+void SoftwareSerial::deliver(uint8_t b) {
+  if (g_listener != this) return; // not listening: the start bit is never seen
+  if (g_ssRx.size() >= (size_t)(SS_MAX_RX_BUFF - 1)) {
+    g_ssOverflow = true;
+    return;
+  }
+  g_ssRx.push_back(b);
+}
@@ -0,0 +1,51 @@
+// HostSim.h
+#pragma once
+#include <Arduino.h>
+#include <string>
+
+/*
+ ============================================================
+ Host simulation core (virtual clock + wires)
+ ============================================================
+ Owns the virtual time base used by the Arduino shim and routes bytes between
+ the firmware's SoftwareSerial ports and emulated devices.
+
+ Time model:
+  - advanceUs() moves the clock in <=100 us steps and ticks every device,
+    so device output is delivered at (close to) its scheduled time.
+  - Every millis()/micros() call costs CLOCK_READ_COST_US of virtual time,
+    standing in for the CPU work around it.
+*/
+
+namespace HostSim {
+
+  // A device on the far side of a UART (e.g. the fake BT201).
+  class Device {
+  public:
+    virtual ~Device() {}
+    // A byte written by the firmware, fully received at nowUs.
+    virtual void onByte(uint8_t b, uint64_t nowUs) = 0;
+    // Called as time advances; emit due bytes via HostSim::driveRx().
+    virtual void tick(uint64_t nowUs) = 0;
+  };
+
+  static const uint32_t CLOCK_READ_COST_US = 4;
+
+  uint64_t nowUs();
+  void advanceUs(uint64_t us);
+
+  // Wire a device to the firmware pins (Arduino RX = device TX and vice versa).
+  void attachDevice(uint8_t arduinoRxPin, uint8_t arduinoTxPin, Device &dev);
+
+  // Device -> firmware: one byte on the firmware's RX pin (lost if not listening).
+  void driveRx(uint8_t arduinoRxPin, uint8_t b);
+
+  // Firmware -> device (called by the SoftwareSerial shim after the byte time).
+  void firmwareTx(uint8_t arduinoTxPin, uint8_t b);
+
+  // USB Serial harness side
+  void consoleType(const char *text);      // bytes the "PC" sends (at 115200 baud)
+  std::string consoleTakeOutput();         // bytes the firmware printed
+  uint32_t consoleInputPending();          // typed but not yet read by the sketch
+  uint32_t consoleRxDropped();             // lost to a full 64-byte RX buffer
+}
@@ -0,0 +1,41 @@
+// SoftwareSerial.h (host shim)
+#pragma once
+#include <Arduino.h>
+
+/*
+ Host model of the AVR SoftwareSerial library:
+  - One shared 64-byte RX buffer; only the listening instance receives.
+  - listen() on another instance discards the shared buffer (as on AVR).
+  - write() blocks for one character time (10 bits at the port's baud).
+ Bytes arrive from devices attached with HostSim::attachDevice().
+*/
+
+class SoftwareSerial : public Stream {
+public:
+  SoftwareSerial(uint8_t rxPin, uint8_t txPin, bool inverse = false);
+  ~SoftwareSerial();
+
+  void begin(long baud);
+  void end();
+  bool listen();
+  bool stopListening();
+  bool isListening();
+  bool overflow();
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t b) override;
+  using Print::write;
+
+  uint8_t rxPin() const { return _rxPin; }
+  long baud() const { return _baud; }
+
+  // Called by HostSim when a device drives this port's RX pin.
+  void deliver(uint8_t b);
+
+private:
+  uint8_t _rxPin;
+  uint8_t _txPin;
+  long _baud;
+};